@@ -39,6 +39,7 @@
 */
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 
 /* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
 all the API functions to use the MPU wrappers.  That should only be done when
@@ -60,6 +61,19 @@ task.h is included from an application file. */
 /* Assumes 8bit bytes! */
 #define heapBITS_PER_BYTE		( ( size_t ) 8 )
 
+/* Number of tasks for which the heap usage is tracked. Slot 0 accounts for the
+allocations made before the scheduler started, and for the tasks that did not
+fit in the table. */
+#define heapMAX_OWNERS			( ( UBaseType_t ) 16 )
+
+/* Requested size of the allocations counted in the first bucket of the size
+histogram. Each following bucket doubles the size. */
+#define heapHISTOGRAM_FIRST_SIZE	( ( size_t ) 16 )
+
+#ifndef configHEAP_TRACE_LENGTH
+ #define configHEAP_TRACE_LENGTH 0
+#endif
+
 /* Define the linked list structure.  This is used to link free blocks in order
 of their memory address. */
 typedef struct A_BLOCK_LINK
@@ -106,12 +120,49 @@ static size_t xBlockAllocatedBit = 0;
 
 static size_t xHeapSize = 0;
 
+/* The bits below xBlockAllocatedBit hold the index of the task that owns an
+allocated block in xOwners. */
+static size_t xBlockOwnerMask = 0;
+static size_t xBlockOwnerShift = 0;
+
+typedef struct HEAP_OWNER
+{
+ void *pvTask;
+ size_t xCurrentBytes;
+ size_t xPeakBytes;
+} HeapOwner_t;
+
+static HeapOwner_t xOwners[ heapMAX_OWNERS ];
+
+static size_t xNumberOfSuccessfulAllocations = 0;
+static size_t xNumberOfSuccessfulFrees = 0;
+static uint32_t ulSizeHistogram[ portHEAP_HISTOGRAM_BUCKETS ];
+
+#if( configHEAP_TRACE_LENGTH > 0 )
+ static HeapTraceEntry_t xTrace[ configHEAP_TRACE_LENGTH ];
+ static UBaseType_t uxTraceCount = 0;
+#endif
+
+/*
+* Returns the index in xOwners of the task currently running, adding it to the
+* table if needed.
+*/
+static UBaseType_t prvGetOwner( void );
+
+/*
+* Records an allocation or a free in the trace ring buffer.
+*/
+static void prvTrace( void *pv, size_t xSize, UBaseType_t uxOwner, uint8_t ucIsFree );
+
 /*-----------------------------------------------------------*/
 
 void *pvPortMalloc( size_t xWantedSize )
 {
  BlockLink_t *pxBlock, *pxPreviousBlock, *pxNewBlockLink;
  void *pvReturn = NULL;
+ size_t xRequestedSize = xWantedSize;
+ UBaseType_t uxOwner, uxBucket;
+ size_t xBucketSize;
 
  vTaskSuspendAll();
  {
@@ -130,7 +181,7 @@ void *pvPortMalloc( size_t xWantedSize )
    set.  The top bit of the block size member of the BlockLink_t structure
    is used to determine who owns the block - the application or the
    kernel, so it must be free. */
-   if( ( xWantedSize & xBlockAllocatedBit ) == 0 )
+   if( ( xWantedSize & ( xBlockAllocatedBit | xBlockOwnerMask ) ) == 0 )
    {
      /* The wanted size is increased so it can contain a BlockLink_t
      structure in addition to the requested amount of bytes. */
@@ -222,9 +273,26 @@ void *pvPortMalloc( size_t xWantedSize )
            mtCOVERAGE_TEST_MARKER();
          }
 
+         /* Account the block to the task requesting it. */
+         uxOwner = prvGetOwner();
+         xOwners[ uxOwner ].xCurrentBytes += pxBlock->xBlockSize;
+         if( xOwners[ uxOwner ].xCurrentBytes > xOwners[ uxOwner ].xPeakBytes )
+         {
+           xOwners[ uxOwner ].xPeakBytes = xOwners[ uxOwner ].xCurrentBytes;
+         }
+
+         uxBucket = 0;
+         for( xBucketSize = heapHISTOGRAM_FIRST_SIZE; ( xRequestedSize > xBucketSize ) && ( uxBucket < portHEAP_HISTOGRAM_BUCKETS - 1 ); xBucketSize <<= 1 )
+         {
+           uxBucket++;
+         }
+         ulSizeHistogram[ uxBucket ]++;
+         xNumberOfSuccessfulAllocations++;
+         prvTrace( pvReturn, xRequestedSize, uxOwner, 0 );
+
          /* The block is being returned - it is allocated and owned
          by the application and has no "next" block. */
-         pxBlock->xBlockSize |= xBlockAllocatedBit;
+         pxBlock->xBlockSize |= xBlockAllocatedBit | ( ( size_t ) uxOwner << xBlockOwnerShift );
          pxBlock->pxNextFreeBlock = NULL;
        }
        else
@@ -269,6 +337,7 @@ void vPortFree( void *pv )
 {
  uint8_t *puc = ( uint8_t * ) pv;
  BlockLink_t *pxLink;
+ UBaseType_t uxOwner;
 
  if( pv != NULL )
  {
@@ -289,10 +358,15 @@ void vPortFree( void *pv )
      {
        /* The block is being returned to the heap - it is no longer
        allocated. */
-       pxLink->xBlockSize &= ~xBlockAllocatedBit;
+       uxOwner = ( UBaseType_t ) ( ( pxLink->xBlockSize & xBlockOwnerMask ) >> xBlockOwnerShift );
+       pxLink->xBlockSize &= ~( xBlockAllocatedBit | xBlockOwnerMask );
 
        vTaskSuspendAll();
        {
+         xOwners[ uxOwner ].xCurrentBytes -= pxLink->xBlockSize;
+         xNumberOfSuccessfulFrees++;
+         prvTrace( pv, pxLink->xBlockSize - xHeapStructSize, uxOwner, 1 );
+
          /* Add this block to the list of free blocks. */
          xFreeBytesRemaining += pxLink->xBlockSize;
          traceFREE( pv, pxLink->xBlockSize );
@@ -313,6 +387,55 @@ void vPortFree( void *pv )
 }
 /*-----------------------------------------------------------*/
 
+void vPortShrink( void *pv, size_t xNewSize )
+{
+ uint8_t *puc = ( uint8_t * ) pv;
+ BlockLink_t *pxLink, *pxNewBlockLink;
+ size_t xBlockSize, xFlags;
+ UBaseType_t uxOwner;
+
+ if( pv == NULL )
+ {
+   return;
+ }
+
+ /* The size of the block kept, header included, rounded up to the alignment. */
+ xNewSize += xHeapStructSize;
+ if( ( xNewSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+ {
+   xNewSize += ( portBYTE_ALIGNMENT - ( xNewSize & portBYTE_ALIGNMENT_MASK ) );
+ }
+
+ puc -= xHeapStructSize;
+ pxLink = ( void * ) puc;
+ configASSERT( ( pxLink->xBlockSize & xBlockAllocatedBit ) != 0 );
+
+ vTaskSuspendAll();
+ {
+   xFlags = pxLink->xBlockSize & ( xBlockAllocatedBit | xBlockOwnerMask );
+   xBlockSize = pxLink->xBlockSize & ~( xBlockAllocatedBit | xBlockOwnerMask );
+
+   /* Split the end of the block off only if it is large enough to be used. */
+   if( ( xNewSize < xBlockSize ) && ( ( xBlockSize - xNewSize ) > heapMINIMUM_BLOCK_SIZE ) )
+   {
+     pxNewBlockLink = ( void * ) ( puc + xNewSize );
+     pxNewBlockLink->xBlockSize = xBlockSize - xNewSize;
+     pxLink->xBlockSize = xNewSize | xFlags;
+
+     uxOwner = ( UBaseType_t ) ( ( xFlags & xBlockOwnerMask ) >> xBlockOwnerShift );
+     xOwners[ uxOwner ].xCurrentBytes -= pxNewBlockLink->xBlockSize;
+     xFreeBytesRemaining += pxNewBlockLink->xBlockSize;
+     prvInsertBlockIntoFreeList( pxNewBlockLink );
+   }
+   else
+   {
+     mtCOVERAGE_TEST_MARKER();
+   }
+ }
+ ( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
 size_t xPortGetFreeHeapSize( void )
 {
  return xFreeBytesRemaining;
@@ -331,12 +454,163 @@ size_t xPortGetHeapSize( void )
 }
 /*-----------------------------------------------------------*/
 
+void vPortGetHeapStats( HeapStats_t *pxHeapStats )
+{
+ BlockLink_t *pxBlock;
+ size_t xBlocks = 0, xMaxSize = 0, xMinSize = SIZE_MAX;
+
+ vTaskSuspendAll();
+ {
+   pxBlock = xStart.pxNextFreeBlock;
+
+   /* pxBlock will be NULL if the heap has not been initialised. */
+   if( pxBlock != NULL )
+   {
+     while( pxBlock != pxEnd )
+     {
+       xBlocks++;
+       if( pxBlock->xBlockSize > xMaxSize )
+       {
+         xMaxSize = pxBlock->xBlockSize;
+       }
+       if( pxBlock->xBlockSize < xMinSize )
+       {
+         xMinSize = pxBlock->xBlockSize;
+       }
+       pxBlock = pxBlock->pxNextFreeBlock;
+     }
+   }
+
+   pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+   pxHeapStats->xSizeOfSmallestFreeBlockInBytes = ( xBlocks > 0 ) ? xMinSize : 0;
+   pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+   pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+   pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+   pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+   pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+ }
+ ( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapHistogram( uint32_t *pulCounts )
+{
+ vTaskSuspendAll();
+ {
+   memcpy( pulCounts, ulSizeHistogram, sizeof( ulSizeHistogram ) );
+ }
+ ( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxPortGetHeapTaskStats( HeapTaskStats_t *pxTaskStats, UBaseType_t uxMaxEntries )
+{
+ UBaseType_t uxOwner, uxCount = 0;
+
+ vTaskSuspendAll();
+ {
+   for( uxOwner = 0; ( uxOwner < heapMAX_OWNERS ) && ( uxCount < uxMaxEntries ); uxOwner++ )
+   {
+     if( ( uxOwner == 0 ) || ( xOwners[ uxOwner ].pvTask != NULL ) )
+     {
+       pxTaskStats[ uxCount ].pvTask = xOwners[ uxOwner ].pvTask;
+       pxTaskStats[ uxCount ].xCurrentBytes = xOwners[ uxOwner ].xCurrentBytes;
+       pxTaskStats[ uxCount ].xPeakBytes = xOwners[ uxOwner ].xPeakBytes;
+       uxCount++;
+     }
+   }
+ }
+ ( void ) xTaskResumeAll();
+
+ return uxCount;
+}
+/*-----------------------------------------------------------*/
+
+#if( configHEAP_TRACE_LENGTH > 0 )
+
+ UBaseType_t uxPortGetHeapTrace( HeapTraceEntry_t *pxEntries, UBaseType_t uxMaxEntries )
+ {
+ UBaseType_t uxCount, uxFirst, x;
+
+   vTaskSuspendAll();
+   {
+     /* Copy the most recent entries, oldest first. */
+     uxCount = ( uxTraceCount < configHEAP_TRACE_LENGTH ) ? uxTraceCount : configHEAP_TRACE_LENGTH;
+     if( uxCount > uxMaxEntries )
+     {
+       uxCount = uxMaxEntries;
+     }
+     uxFirst = uxTraceCount - uxCount;
+     for( x = 0; x < uxCount; x++ )
+     {
+       pxEntries[ x ] = xTrace[ ( uxFirst + x ) % configHEAP_TRACE_LENGTH ];
+     }
+   }
+   ( void ) xTaskResumeAll();
+
+   return uxCount;
+ }
+
+#endif /* configHEAP_TRACE_LENGTH */
+/*-----------------------------------------------------------*/
+
 void vPortInitialiseBlocks( void )
 {
  /* This just exists to keep the linker quiet. */
 }
 /*-----------------------------------------------------------*/
 
+static UBaseType_t prvGetOwner( void )
+{
+ void *pvTask;
+ UBaseType_t uxOwner;
+
+ if( xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED )
+ {
+   return 0;
+ }
+
+ pvTask = ( void * ) xTaskGetCurrentTaskHandle();
+ for( uxOwner = 1; uxOwner < heapMAX_OWNERS; uxOwner++ )
+ {
+   if( xOwners[ uxOwner ].pvTask == pvTask )
+   {
+     return uxOwner;
+   }
+   if( xOwners[ uxOwner ].pvTask == NULL )
+   {
+     xOwners[ uxOwner ].pvTask = pvTask;
+     return uxOwner;
+   }
+ }
+
+ return 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTrace( void *pv, size_t xSize, UBaseType_t uxOwner, uint8_t ucIsFree )
+{
+#if( configHEAP_TRACE_LENGTH > 0 )
+ {
+ HeapTraceEntry_t *pxEntry = &xTrace[ uxTraceCount % configHEAP_TRACE_LENGTH ];
+
+   pxEntry->pvAddress = pv;
+   pxEntry->usSize = ( xSize > 0xFFFF ) ? 0xFFFF : ( uint16_t ) xSize;
+   pxEntry->ucOwner = ( uint8_t ) uxOwner;
+   pxEntry->ucIsFree = ucIsFree;
+   uxTraceCount++;
+ }
+#else
+ {
+   ( void ) pv;
+   ( void ) xSize;
+   ( void ) uxOwner;
+   ( void ) ucIsFree;
+ }
+#endif
+}
+/*-----------------------------------------------------------*/
+
 extern uint8_t *__HeapLimit; // Defined by nrf_common.ld
 
 static void prvHeapInit( void )
@@ -387,6 +661,10 @@ static void prvHeapInit( void )
 
  /* Work out the position of the top bit in a size_t variable. */
  xBlockAllocatedBit = ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 1 );
+
+ /* The owner index is stored in the 4 bits below it. */
+ xBlockOwnerShift = ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 5;
+ xBlockOwnerMask = ( ( size_t ) heapMAX_OWNERS - 1 ) << xBlockOwnerShift;
 }
 /*-----------------------------------------------------------*/
 
@@ -478,7 +756,7 @@ void* pvPortRealloc(void* pv, size_t xWantedSize) {
  // Check allocate block
  if ((pxLink->xBlockSize & xBlockAllocatedBit) != 0) {
    // The block is being returned to the heap - it is no longer allocated.
-   block_size = (pxLink->xBlockSize & ~xBlockAllocatedBit) - xHeapStructSize;
+   block_size = (pxLink->xBlockSize & ~(xBlockAllocatedBit | xBlockOwnerMask)) - xHeapStructSize;
 
    // Allocate a new buffer
    pvReturn = pvPortMalloc(xWantedSize);
@@ -0,0 +1,87 @@
+/*
+ * Run-time statistics time base (configGENERATE_RUN_TIME_STATS).
+ *
+ * The counter is TIMER3, a 32-bit timer that no other driver uses (RTC0 is
+ * owned by the BLE stack, RTC1 is the tick and RTC2 drives the backlight PWM).
+ * It is prescaled to 31250Hz and wraps after about 38 hours. A TIMER needs the
+ * HF clock, so while RUNTIME_STATS is enabled the HF clock stays requested
+ * during sleep: the sleep time is still measured, but the current drawn while
+ * sleeping is higher than in a normal build.
+ *
+ * On top of the per-task run time maintained by the kernel, the time spent in
+ * tickless idle and in the SPI/TWI/GPIOTE interrupt handlers is accumulated
+ * here. Interrupt time is also included in the run time of the task it
+ * interrupted, and at 32us resolution it is a statistical estimate: short
+ * handlers are mostly measured as 0 or 1 count.
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "nrf_timer.h"
+
+#define portRUN_TIME_TIMER_REG NRF_TIMER3
+/* CC channel used to capture the counter */
+#define portRUN_TIME_TIMER_CC NRF_TIMER_CC_CHANNEL0
+
+static uint32_t ulSleepStart = 0;
+static uint32_t ulSleepTime = 0;
+static uint32_t ulSleepCount = 0;
+static uint32_t ulIsrTime[portRUN_TIME_ISR_COUNT] = {0};
+static uint32_t ulIsrCount[portRUN_TIME_ISR_COUNT] = {0};
+
+void vPortRunTimeStatsInit(void)
+{
+    nrf_timer_mode_set(portRUN_TIME_TIMER_REG, NRF_TIMER_MODE_TIMER);
+    nrf_timer_bit_width_set(portRUN_TIME_TIMER_REG, NRF_TIMER_BIT_WIDTH_32);
+    nrf_timer_frequency_set(portRUN_TIME_TIMER_REG, NRF_TIMER_FREQ_31250Hz);
+    nrf_timer_task_trigger(portRUN_TIME_TIMER_REG, NRF_TIMER_TASK_CLEAR);
+    nrf_timer_task_trigger(portRUN_TIME_TIMER_REG, NRF_TIMER_TASK_START);
+}
+
+uint32_t ulPortGetRunTimeCounterValue(void)
+{
+    /* The capture task and the read of the CC register must not be split by
+    another capture from an interrupt handler. */
+    uint32_t ulMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    nrf_timer_task_trigger(portRUN_TIME_TIMER_REG, nrf_timer_capture_task_get(portRUN_TIME_TIMER_CC));
+    uint32_t ulCounter = nrf_timer_cc_read(portRUN_TIME_TIMER_REG, portRUN_TIME_TIMER_CC);
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(ulMask);
+
+    return ulCounter;
+}
+
+/* Called from vPortSuppressTicksAndSleep() with interrupts disabled. */
+void vPortRunTimeSleepEnter(void)
+{
+    ulSleepStart = ulPortGetRunTimeCounterValue();
+}
+
+void vPortRunTimeSleepExit(void)
+{
+    ulSleepTime += ulPortGetRunTimeCounterValue() - ulSleepStart;
+    ulSleepCount++;
+}
+
+void vPortRunTimeIsrExit(eRunTimeIsr eIsr, uint32_t ulStartTime)
+{
+    uint32_t ulMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    ulIsrTime[eIsr] += ulPortGetRunTimeCounterValue() - ulStartTime;
+    ulIsrCount[eIsr]++;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(ulMask);
+}
+
+void vPortGetRunTimeStats(RunTimeStats_t* pxRunTimeStats)
+{
+    taskENTER_CRITICAL();
+    {
+        pxRunTimeStats->ulTotalTime = ulPortGetRunTimeCounterValue();
+        pxRunTimeStats->ulSleepTime = ulSleepTime;
+        pxRunTimeStats->ulSleepCount = ulSleepCount;
+        for (UBaseType_t i = 0; i < portRUN_TIME_ISR_COUNT; i++)
+        {
+            pxRunTimeStats->ulIsrTime[i] = ulIsrTime[i];
+            pxRunTimeStats->ulIsrCount[i] = ulIsrCount[i];
+        }
+    }
+    taskEXIT_CRITICAL();
+}
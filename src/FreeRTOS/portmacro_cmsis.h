@@ -182,6 +182,89 @@ __STATIC_INLINE uint32_t ulPortRaiseBASEPRI( void )
 
 size_t xPortGetHeapSize(void);
 
+/* Gives the end of an allocated block back to the heap, keeping its first
+ * xNewSize bytes in place. */
+void vPortShrink(void* pv, size_t xNewSize);
+
+/* Heap statistics, see heap_4_infinitime.c */
+typedef struct xHeapStats
+{
+    size_t xAvailableHeapSpaceInBytes;
+    size_t xSizeOfLargestFreeBlockInBytes;
+    size_t xSizeOfSmallestFreeBlockInBytes;
+    size_t xNumberOfFreeBlocks;
+    size_t xMinimumEverFreeBytesRemaining;
+    size_t xNumberOfSuccessfulAllocations;
+    size_t xNumberOfSuccessfulFrees;
+} HeapStats_t;
+
+void vPortGetHeapStats(HeapStats_t* pxHeapStats);
+
+/* Number of allocations by requested size: up to 16, 32, 64, 128, 256, 512,
+ * 1024 bytes, and larger. */
+#define portHEAP_HISTOGRAM_BUCKETS 8
+void vPortGetHeapHistogram(uint32_t* pulCounts);
+
+/* Heap usage of a task (block headers included). pvTask is the handle of the
+ * task, or NULL for the allocations made before the scheduler started. */
+typedef struct xHeapTaskStats
+{
+    void* pvTask;
+    size_t xCurrentBytes;
+    size_t xPeakBytes;
+} HeapTaskStats_t;
+
+UBaseType_t uxPortGetHeapTaskStats(HeapTaskStats_t* pxTaskStats, UBaseType_t uxMaxEntries);
+
+/* Allocation trace, recorded when configHEAP_TRACE_LENGTH is not 0. ucOwner
+ * is the index of the task in the table returned by uxPortGetHeapTaskStats. */
+typedef struct xHeapTraceEntry
+{
+    void* pvAddress;
+    uint16_t usSize;
+    uint8_t ucOwner;
+    uint8_t ucIsFree;
+} HeapTraceEntry_t;
+
+UBaseType_t uxPortGetHeapTrace(HeapTraceEntry_t* pxEntries, UBaseType_t uxMaxEntries);
+
+/* Run-time statistics, see port_runtime_stats.c. All times are in counts of
+ * the run-time counter, which runs at portRUN_TIME_STATS_HZ. */
+#define portRUN_TIME_STATS_HZ 31250
+
+typedef enum
+{
+    eRunTimeIsrSpi = 0,
+    eRunTimeIsrTwi,
+    eRunTimeIsrGpiote
+} eRunTimeIsr;
+#define portRUN_TIME_ISR_COUNT 3
+
+typedef struct xRunTimeStats
+{
+    uint32_t ulTotalTime;
+    uint32_t ulSleepTime;
+    uint32_t ulSleepCount;
+    uint32_t ulIsrTime[portRUN_TIME_ISR_COUNT];
+    uint32_t ulIsrCount[portRUN_TIME_ISR_COUNT];
+} RunTimeStats_t;
+
+void vPortRunTimeStatsInit(void);
+uint32_t ulPortGetRunTimeCounterValue(void);
+void vPortRunTimeSleepEnter(void);
+void vPortRunTimeSleepExit(void);
+void vPortRunTimeIsrExit(eRunTimeIsr eIsr, uint32_t ulStartTime);
+void vPortGetRunTimeStats(RunTimeStats_t* pxRunTimeStats);
+
+/* Brackets an interrupt handler to account its time to eIsr. */
+#if configGENERATE_RUN_TIME_STATS == 1
+    #define portRUN_TIME_ISR_ENTER()      const uint32_t ulRunTimeIsrStart = ulPortGetRunTimeCounterValue()
+    #define portRUN_TIME_ISR_EXIT( eIsr ) vPortRunTimeIsrExit( ( eIsr ), ulRunTimeIsrStart )
+#else
+    #define portRUN_TIME_ISR_ENTER()
+    #define portRUN_TIME_ISR_EXIT( eIsr )
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -83,9 +83,20 @@
 #define configUSE_MALLOC_FAILED_HOOK   1
 
 /* Run time and task stats gathering related definitions. */
-#define configGENERATE_RUN_TIME_STATS        0
+#ifdef RUNTIME_STATS
+  /* Time base and sleep accounting are implemented in FreeRTOS/port_runtime_stats.c */
+  #define configGENERATE_RUN_TIME_STATS            1
+  #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() vPortRunTimeStatsInit()
+  #define portGET_RUN_TIME_COUNTER_VALUE()         ulPortGetRunTimeCounterValue()
+  #define configPRE_SLEEP_PROCESSING(x)            vPortRunTimeSleepEnter()
+  #define configPOST_SLEEP_PROCESSING(x)           vPortRunTimeSleepExit()
+#else
+  #define configGENERATE_RUN_TIME_STATS 0
+#endif
 #define configUSE_TRACE_FACILITY             1
 #define configUSE_STATS_FORMATTING_FUNCTIONS 0
+/* Number of allocations and frees recorded by heap_4_infinitime.c (0 to disable the trace) */
+#define configHEAP_TRACE_LENGTH 0
 
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES           0
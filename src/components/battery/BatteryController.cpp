@@ -1,5 +1,6 @@
 #include "components/battery/BatteryController.h"
 #include "utility/LinearApproximation.h"
+#include "utility/ChangeBus.h"
 #include "drivers/PinMap.h"
 #include <hal/nrf_gpio.h>
 #include <nrfx_saadc.h>
@@ -16,8 +17,13 @@ Battery::Battery() {
 }
 
 void Battery::ReadPowerState() {
+  const bool wasCharging = isCharging;
+  const bool wasPowerPresent = isPowerPresent;
   isCharging = (nrf_gpio_pin_read(PinMap::Charging) == 0);
   isPowerPresent = (nrf_gpio_pin_read(PinMap::PowerPresent) == 0);
+  if (isCharging != wasCharging || isPowerPresent != wasPowerPresent) {
+    Utility::ChangeBus::Publish(Utility::Topic::Battery);
+  }
 
   if (isPowerPresent && !isCharging) {
     isFull = true;
@@ -84,6 +90,7 @@ void Battery::SaadcEventHandler(nrfx_saadc_evt_t const* p_event) {
     if ((isPowerPresent && newPercent > percentRemaining) || (!isPowerPresent && newPercent < percentRemaining) || firstMeasurement) {
       firstMeasurement = false;
       percentRemaining = newPercent;
+      Utility::ChangeBus::Publish(Utility::Topic::Battery);
       systemTask->PushMessage(System::Messages::BatteryPercentageUpdated);
     }
 
@@ -60,25 +60,24 @@ int AlertNotificationService::OnAlert(struct ble_gatt_access_ctxt* ctxt) {
     size_t bufferSize = std::min(packetLen + stringTerminatorSize, maxBufferSize);
     auto messageSize = std::min(maxMessageSize, (bufferSize - headerSize));
     Categories category;
-
-    NotificationManager::Notification notif;
-    os_mbuf_copydata(ctxt->om, headerSize, messageSize - 1, notif.message.data());
     os_mbuf_copydata(ctxt->om, 0, 1, &category);
-    notif.message[messageSize - 1] = '\0';
-    notif.size = messageSize;
 
     // TODO convert all ANS categories to NotificationController categories
+    NotificationManager::Categories notificationCategory;
     switch (category) {
       case Categories::Call:
-        notif.category = Pinetime::Controllers::NotificationManager::Categories::IncomingCall;
+        notificationCategory = Pinetime::Controllers::NotificationManager::Categories::IncomingCall;
         break;
       default:
-        notif.category = Pinetime::Controllers::NotificationManager::Categories::SimpleAlert;
+        notificationCategory = Pinetime::Controllers::NotificationManager::Categories::SimpleAlert;
         break;
     }
 
+    char* message = notificationManager.Reserve(messageSize);
+    os_mbuf_copydata(ctxt->om, headerSize, messageSize - 1, message);
+    notificationManager.Commit(notificationCategory, messageSize);
+
     auto event = Pinetime::System::Messages::OnNewNotification;
-    notificationManager.Push(std::move(notif));
     systemTask.PushMessage(event);
   }
   return 0;
@@ -1,4 +1,5 @@
 #include "components/ble/BleController.h"
+#include "utility/ChangeBus.h"
 
 using namespace Pinetime::Controllers;
 
@@ -8,10 +9,12 @@ bool Ble::IsConnected() const {
 
 void Ble::Connect() {
   isConnected = true;
+  Utility::ChangeBus::Publish(Utility::Topic::Ble);
 }
 
 void Ble::Disconnect() {
   isConnected = false;
+  Utility::ChangeBus::Publish(Utility::Topic::Ble);
 }
 
 bool Ble::IsRadioEnabled() const {
@@ -20,10 +23,12 @@ bool Ble::IsRadioEnabled() const {
 
 void Ble::EnableRadio() {
   isRadioEnabled = true;
+  Utility::ChangeBus::Publish(Utility::Topic::Ble);
 }
 
 void Ble::DisableRadio() {
   isRadioEnabled = false;
+  Utility::ChangeBus::Publish(Utility::Topic::Ble);
 }
 
 void Ble::StartFirmwareUpdate() {
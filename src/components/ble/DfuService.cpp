@@ -1,8 +1,10 @@
 #include "components/ble/DfuService.h"
+#include <algorithm>
 #include <cstring>
 #include "components/ble/BleController.h"
 #include "drivers/SpiNorFlash.h"
 #include "systemtask/SystemTask.h"
+#include "utility/Crc16.h"
 #include <nrf_log.h>
 
 using namespace Pinetime::Controllers;
@@ -163,8 +165,10 @@ int DfuService::WritePacketHandler(uint16_t connectionHandle, os_mbuf* om) {
 
     case States::Data: {
       nbPacketReceived++;
-      dfuImage.Append(om->om_data, om->om_len);
-      bytesReceived += om->om_len;
+      for (os_mbuf* buffer = om; buffer != nullptr; buffer = SLIST_NEXT(buffer, om_next)) {
+        dfuImage.Append(buffer->om_data, buffer->om_len);
+      }
+      bytesReceived += OS_MBUF_PKTLEN(om);
       bleController.FirmwareUpdateCurrentBytes(bytesReceived);
 
       if ((nbPacketReceived % nbPacketsToNotify) == 0 && bytesReceived != applicationSize) {
@@ -248,8 +252,7 @@ int DfuService::ControlPointHandler(uint16_t connectionHandle, os_mbuf* om) {
         NRF_LOG_INFO("[DFU] -> Receive firmware image requested, but we are not in Start Init");
         return 0;
       }
-      // TODO the chunk size is dependent of the implementation of the host application...
-      dfuImage.Init(20, applicationSize, expectedCrc);
+      dfuImage.Init(applicationSize, expectedCrc);
       NRF_LOG_INFO("[DFU] -> Starting receive firmware");
       state = States::Data;
       return 0;
@@ -352,36 +355,118 @@ void DfuService::NotificationManager::Reset() {
   xTimerStop(timer, 0);
 }
 
-void DfuService::DfuImage::Init(size_t chunkSize, size_t totalSize, uint16_t expectedCrc) {
-  if (chunkSize != 20)
+DfuService::DfuImage::DfuImage(Pinetime::Drivers::SpiNorFlash& spiNorFlash) : spiNorFlash {spiNorFlash} {
+  freeBuffers = xQueueCreate(nbBuffers, sizeof(uint8_t));
+  for (uint8_t i = 0; i < nbBuffers; i++) {
+    xQueueSend(freeBuffers, &i, 0);
+  }
+  // Room for every buffer and a flush marker
+  pendingPages = xQueueCreate(nbBuffers + 1, sizeof(uint32_t));
+  writesDone = xSemaphoreCreateBinary();
+}
+
+void DfuService::DfuImage::Init(size_t totalSize, uint16_t expectedCrc) {
+  // The writer task is only created for the first firmware update
+  if (writerTask == nullptr && xTaskCreate(DfuImage::ProcessWrites, "DFU", 200, this, 1, &writerTask) != pdPASS) {
+    writerTask = nullptr;
+    this->ready = false;
     return;
-  this->chunkSize = chunkSize;
+  }
+  WaitForWrites();
+  if (bufferWriteIndex > 0) {
+    // Drop the data left over from an aborted transfer
+    xQueueSend(freeBuffers, &currentBuffer, 0);
+  }
   this->totalSize = totalSize;
   this->expectedCrc = expectedCrc;
   this->ready = true;
   totalWriteIndex = 0;
   bufferWriteIndex = 0;
+  crc = 0xFFFF;
 }
 
-void DfuService::DfuImage::Append(uint8_t* data, size_t size) {
+void DfuService::DfuImage::Append(const uint8_t* data, size_t size) {
   if (!ready)
     return;
-  ASSERT(size <= 20);
 
-  std::memcpy(tempBuffer + bufferWriteIndex, data, size);
-  bufferWriteIndex += size;
+  while (size > 0 && totalWriteIndex < totalSize) {
+    if (bufferWriteIndex == 0) {
+      // Blocks only while every buffer is still waiting to be written
+      xQueueReceive(freeBuffers, &currentBuffer, portMAX_DELAY);
+    }
+    size_t toCopy = std::min(size, bufferSize - bufferWriteIndex);
+    std::memcpy(buffers[currentBuffer].data() + bufferWriteIndex, data, toCopy);
+    crc = Pinetime::Utility::Crc16(data, toCopy, crc);
+    bufferWriteIndex += toCopy;
+    data += toCopy;
+    size -= toCopy;
+
+    if (bufferWriteIndex == bufferSize || totalWriteIndex + bufferWriteIndex >= totalSize) {
+      SubmitBuffer();
+    }
+  }
+}
+
+void DfuService::DfuImage::SubmitBuffer() {
+  // Pages start on a multiple of bufferSize, the low bits carry the index of the buffer
+  uint32_t page = totalWriteIndex | currentBuffer;
+  xQueueSend(pendingPages, &page, portMAX_DELAY);
+  totalWriteIndex += bufferWriteIndex;
+  bufferWriteIndex = 0;
+}
+
+void DfuService::DfuImage::WritePage(uint32_t page) {
+  size_t offset = page & ~(bufferSize - 1);
+  uint8_t index = page & (bufferSize - 1);
+  size_t size = std::min(bufferSize, totalSize - offset);
+
+  EraseUpTo(offset + size - 1);
+  spiNorFlash.Write(writeOffset + offset, buffers[index].data(), size);
+
+  if ((offset % sectorSize) == 0 && offset + sectorSize < totalSize) {
+    // Erase the next sector while the rest of this one is being received
+    EraseUpTo(offset + sectorSize);
+  }
+
+  if (offset + size == totalSize && totalSize < maxSize) {
+    size_t magicOffset = maxSize - (4 * sizeof(uint32_t));
+    if (magicOffset >= erasedSize) {
+      spiNorFlash.SectorErase(writeOffset + magicOffset - (magicOffset % sectorSize));
+    }
+    WriteMagicNumber();
+  }
+
+  xQueueSend(freeBuffers, &index, 0);
+}
 
-  if (bufferWriteIndex == bufferSize) {
-    spiNorFlash.Write(writeOffset + totalWriteIndex, tempBuffer, bufferWriteIndex);
-    totalWriteIndex += bufferWriteIndex;
-    bufferWriteIndex = 0;
+void DfuService::DfuImage::ProcessWrites(void* instance) {
+  auto* image = static_cast<DfuImage*>(instance);
+  uint32_t page;
+  while (true) {
+    if (xQueueReceive(image->pendingPages, &page, portMAX_DELAY) == pdTRUE) {
+      if (page == flushMarker) {
+        // All the pages submitted before the marker are written
+        xSemaphoreGive(image->writesDone);
+      } else {
+        image->WritePage(page);
+      }
+    }
   }
+}
 
-  if (bufferWriteIndex > 0 && totalWriteIndex + bufferWriteIndex == totalSize) {
-    spiNorFlash.Write(writeOffset + totalWriteIndex, tempBuffer, bufferWriteIndex);
-    totalWriteIndex += bufferWriteIndex;
-    if (totalSize < maxSize)
-      WriteMagicNumber();
+void DfuService::DfuImage::WaitForWrites() {
+  if (writerTask == nullptr) {
+    return;
+  }
+  uint32_t marker = flushMarker;
+  xQueueSend(pendingPages, &marker, portMAX_DELAY);
+  xSemaphoreTake(writesDone, portMAX_DELAY);
+}
+
+void DfuService::DfuImage::EraseUpTo(size_t offset) {
+  while (erasedSize <= offset) {
+    spiNorFlash.SectorErase(writeOffset + erasedSize);
+    erasedSize += sectorSize;
   }
 }
 
@@ -399,44 +484,31 @@ void DfuService::DfuImage::WriteMagicNumber() {
 }
 
 void DfuService::DfuImage::Erase() {
-  for (size_t erased = 0; erased < maxSize; erased += 0x1000) {
-    spiNorFlash.SectorErase(writeOffset + erased);
-  }
+  // Only the first sector is erased up front, the following ones are erased as the image is written
+  WaitForWrites();
+  erasedSize = 0;
+  EraseUpTo(0);
 }
 
 bool DfuService::DfuImage::Validate() {
-  uint32_t chunkSize = 200;
-  size_t currentOffset = 0;
-  uint16_t crc = 0;
+  WaitForWrites();
+  if (crc != expectedCrc) {
+    return false;
+  }
 
-  bool first = true;
+#ifdef DFU_READ_BACK
+  size_t currentOffset = 0;
+  uint16_t flashCrc = 0xFFFF;
   while (currentOffset < totalSize) {
-    uint32_t readSize = (totalSize - currentOffset) > chunkSize ? chunkSize : (totalSize - currentOffset);
-
-    spiNorFlash.Read(writeOffset + currentOffset, tempBuffer, readSize);
-    if (first) {
-      crc = ComputeCrc(tempBuffer, readSize, NULL);
-      first = false;
-    } else
-      crc = ComputeCrc(tempBuffer, readSize, &crc);
+    uint32_t readSize = std::min(bufferSize, totalSize - currentOffset);
+    spiNorFlash.Read(writeOffset + currentOffset, buffers[0].data(), readSize);
+    flashCrc = Pinetime::Utility::Crc16(buffers[0].data(), readSize, flashCrc);
     currentOffset += readSize;
   }
-
-  return (crc == expectedCrc);
-}
-
-uint16_t DfuService::DfuImage::ComputeCrc(uint8_t const* p_data, uint32_t size, uint16_t const* p_crc) {
-  uint16_t crc = (p_crc == NULL) ? 0xFFFF : *p_crc;
-
-  for (uint32_t i = 0; i < size; i++) {
-    crc = static_cast<uint8_t>(crc >> 8) | (crc << 8);
-    crc ^= p_data[i];
-    crc ^= static_cast<uint8_t>(crc & 0xFF) >> 4;
-    crc ^= (crc << 8) << 4;
-    crc ^= ((crc & 0xFF) << 4) << 1;
-  }
-
-  return crc;
+  return (flashCrc == expectedCrc);
+#else
+  return true;
+#endif
 }
 
 bool DfuService::DfuImage::IsComplete() {
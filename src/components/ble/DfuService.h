@@ -2,6 +2,10 @@
 
 #include <cstdint>
 #include <array>
+#include <FreeRTOS.h>
+#include <queue.h>
+#include <semphr.h>
+#include <task.h>
 
 #define min // workaround: nimble's min/max macros conflict with libstdc++
 #define max
@@ -51,30 +55,47 @@ namespace Pinetime {
 
       class DfuImage {
       public:
-        DfuImage(Pinetime::Drivers::SpiNorFlash& spiNorFlash) : spiNorFlash {spiNorFlash} {
-        }
+        DfuImage(Pinetime::Drivers::SpiNorFlash& spiNorFlash);
 
-        void Init(size_t chunkSize, size_t totalSize, uint16_t expectedCrc);
+        void Init(size_t totalSize, uint16_t expectedCrc);
         void Erase();
-        void Append(uint8_t* data, size_t size);
+        void Append(const uint8_t* data, size_t size);
         bool Validate();
         bool IsComplete();
 
       private:
         Pinetime::Drivers::SpiNorFlash& spiNorFlash;
-        static constexpr size_t bufferSize = 200;
+        // The image is buffered one flash page at a time. Full pages are written by a dedicated writer
+        // task so that the BLE host is only held back when all the buffers are waiting for the flash.
+        static constexpr size_t bufferSize = 256;
+        static constexpr size_t nbBuffers = 4;
+        static constexpr size_t sectorSize = 0x1000;
         bool ready = false;
-        size_t chunkSize = 0;
         size_t totalSize = 0;
         size_t maxSize = 475136;
         size_t bufferWriteIndex = 0;
         size_t totalWriteIndex = 0;
+        size_t erasedSize = 0;
         static constexpr size_t writeOffset = 0x40000;
-        uint8_t tempBuffer[bufferSize];
+        std::array<std::array<uint8_t, bufferSize>, nbBuffers> buffers;
+        uint8_t currentBuffer = 0;
+        QueueHandle_t freeBuffers;
+        // Pages waiting for the writer task, see SubmitBuffer()
+        QueueHandle_t pendingPages;
+        SemaphoreHandle_t writesDone;
+        TaskHandle_t writerTask = nullptr;
+        static constexpr uint32_t flushMarker = 0xFFFFFFFF;
         uint16_t expectedCrc = 0;
-
+        // Computed as the image is received
+        uint16_t crc = 0xFFFF;
+
+        static void ProcessWrites(void* instance);
+        // Runs in the writer task: programs a buffered page and erases the flash ahead of it
+        void WritePage(uint32_t page);
+        void SubmitBuffer();
+        void WaitForWrites();
+        void EraseUpTo(size_t offset);
         void WriteMagicNumber();
-        uint16_t ComputeCrc(uint8_t const* p_data, uint32_t size, uint16_t const* p_crc);
       };
 
       static constexpr ble_uuid128_t serviceUuid {
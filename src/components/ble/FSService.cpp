@@ -1,4 +1,6 @@
+#include <cstring>
 #include <nrf_log.h>
+#include <nimble/nimble_port.h>
 #include "FSService.h"
 #include "components/ble/BleController.h"
 #include "systemtask/SystemTask.h"
@@ -14,6 +16,16 @@ int FSServiceCallback(uint16_t conn_handle, uint16_t attr_handle, struct ble_gat
   return fsService->OnFSServiceRequested(conn_handle, attr_handle, ctxt);
 }
 
+void FSSessionTimeoutCallback(ble_npl_event* event) {
+  auto* fsService = static_cast<FSService*>(ble_npl_event_get_arg(event));
+  fsService->Reset();
+}
+
+void FSStreamCallback(ble_npl_event* event) {
+  auto* fsService = static_cast<FSService*>(ble_npl_event_get_arg(event));
+  fsService->OnStreamCallout();
+}
+
 FSService::FSService(Pinetime::System::SystemTask& systemTask, Pinetime::Controllers::FS& fs)
   : systemTask {systemTask},
     fs {fs},
@@ -37,6 +49,7 @@ FSService::FSService(Pinetime::System::SystemTask& systemTask, Pinetime::Control
        .characteristics = characteristicDefinition},
       {0},
     } {
+  sessionMutex = xSemaphoreCreateMutex();
 }
 
 void FSService::Init() {
@@ -46,6 +59,11 @@ void FSService::Init() {
 
   res = ble_gatts_add_svcs(serviceDefinition);
   ASSERT(res == 0);
+
+  // The callouts run on the host task, like the GATT callbacks, so closing the session on timeout
+  // (which commits the file to flash) doesn't block the timer daemon
+  ble_npl_callout_init(&sessionCallout, nimble_port_get_dflt_eventq(), FSSessionTimeoutCallback, this);
+  ble_npl_callout_init(&streamCallout, nimble_port_get_dflt_eventq(), FSStreamCallback, this);
 }
 
 int FSService::OnFSServiceRequested(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context) {
@@ -55,11 +73,217 @@ int FSService::OnFSServiceRequested(uint16_t connectionHandle, uint16_t attribut
     return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
   }
   if (attributeHandle == transferCharacteristicHandle) {
-    return FSCommandHandler(connectionHandle, context->om);
+    xSemaphoreTake(sessionMutex, portMAX_DELAY);
+    int res = FSCommandHandler(connectionHandle, context->om);
+    if (state != FSState::IDLE) {
+      ble_npl_callout_reset(&sessionCallout, sessionTimeout);
+    }
+    xSemaphoreGive(sessionMutex);
+    return res;
+  }
+  return 0;
+}
+
+void FSService::Reset() {
+  xSemaphoreTake(sessionMutex, portMAX_DELAY);
+  CloseSession();
+  xSemaphoreGive(sessionMutex);
+}
+
+void FSService::OnStreamCallout() {
+  xSemaphoreTake(sessionMutex, portMAX_DELAY);
+  if (state == FSState::READ && streamActive) {
+    const uint16_t connectionHandle = streamConnection;
+    const uint32_t offset = streamOffset;
+    int res = ContinueStream();
+    if (res < 0) {
+      SendReadError(connectionHandle, offset, res);
+    }
+    if (state != FSState::IDLE) {
+      ble_npl_callout_reset(&sessionCallout, sessionTimeout);
+    }
+  }
+  xSemaphoreGive(sessionMutex);
+}
+
+int FSService::OpenSession(FSState mode) {
+  CloseSession();
+  int res = fs.FileOpen(&file, filepath, mode == FSState::WRITE ? LFS_O_RDWR | LFS_O_CREAT : LFS_O_RDONLY);
+  if (res < 0) {
+    return res;
+  }
+  state = mode;
+  stagingOffset = 0;
+  stagingSize = 0;
+  return 0;
+}
+
+int FSService::CloseSession() {
+  if (state == FSState::IDLE) {
+    return 0;
+  }
+  int res = 0;
+  StopStream();
+  if (state == FSState::WRITE) {
+    res = FlushStaging();
+  }
+  int closeRes = fs.FileClose(&file);
+  state = FSState::IDLE;
+  ble_npl_callout_stop(&sessionCallout);
+  return (res < 0) ? res : closeRes;
+}
+
+int FSService::StageWrite(uint32_t offset, const uint8_t* data, uint32_t size) {
+  if (offset != stagingOffset + stagingSize) {
+    int res = FlushStaging();
+    if (res < 0) {
+      return res;
+    }
+    stagingOffset = offset;
+  }
+  while (size > 0) {
+    // The staged data never crosses a page boundary in the file
+    uint32_t available = staging.size() - (stagingOffset % staging.size()) - stagingSize;
+    uint32_t toCopy = std::min(size, available);
+    std::memcpy(staging.data() + stagingSize, data, toCopy);
+    stagingSize += toCopy;
+    data += toCopy;
+    size -= toCopy;
+    if (toCopy == available) {
+      int res = FlushStaging();
+      if (res < 0) {
+        return res;
+      }
+    }
+  }
+  return 0;
+}
+
+int FSService::FlushStaging() {
+  if (stagingSize == 0) {
+    return 0;
+  }
+  int res = fs.FileSeek(&file, stagingOffset);
+  if (res >= 0) {
+    res = fs.FileWrite(&file, staging.data(), stagingSize);
+  }
+  stagingOffset += stagingSize;
+  stagingSize = 0;
+  return (res < 0) ? res : 0;
+}
+
+int FSService::StreamRead(uint16_t connectionHandle, uint32_t offset, uint32_t size) {
+  StopStream();
+  const uint32_t totalSize = fileSize;
+  int res = fs.FileSeek(&file, offset);
+  if (res < 0) {
+    return res;
+  }
+  streamConnection = connectionHandle;
+  streamOffset = offset;
+  streamRemaining = (offset < totalSize) ? std::min(size, totalSize - offset) : 0;
+  streamActive = true;
+  // Keep the system (and the SPI flash) awake until the whole chunk is sent
+  systemTask.PushMessage(Pinetime::System::Messages::StartFileTransfer);
+  return ContinueStream();
+}
+
+int FSService::ContinueStream() {
+  // Each notification carries the response header and as much data as fits in the ATT MTU
+  // (minus the opcode and attribute handle)
+  const uint32_t maxChunk = ble_att_mtu(streamConnection) - 3 - sizeof(ReadResponse);
+  const uint32_t totalSize = fileSize;
+
+  // An empty chunk (read at the end of the file) is still answered with one notification
+  bool finished = false;
+  for (int sent = 0; !finished && sent < maxBatchSize && os_msys_num_free() >= minFreeBuffers; sent++) {
+    ReadResponse resp;
+    resp.command = commands::READ_DATA;
+    resp.status = 0x01;
+    resp.chunkoff = streamOffset;
+    resp.totallen = totalSize;
+    resp.chunklen = std::min(streamRemaining, maxChunk);
+
+    os_mbuf* om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
+    if (om == nullptr) {
+      break;
+    }
+    // Read the file straight into the mbuf chain
+    uint32_t remaining = resp.chunklen;
+    while (remaining > 0) {
+      uint16_t toRead = std::min(remaining, static_cast<uint32_t>(om->om_omp->omp_databuf_len));
+      auto* data = static_cast<uint8_t*>(os_mbuf_extend(om, toRead));
+      int res = (data == nullptr) ? LFS_ERR_NOMEM : fs.FileRead(&file, data, toRead);
+      if (res != toRead) {
+        os_mbuf_free_chain(om);
+        StopStream();
+        return (res < 0) ? res : LFS_ERR_IO;
+      }
+      remaining -= toRead;
+    }
+
+    // The mbuf is consumed even if the notification can't be queued
+    int res = ble_gattc_notify_custom(streamConnection, transferCharacteristicHandle, om);
+    if (res == BLE_HS_ENOMEM) {
+      // Send the same data again on the next attempt
+      res = fs.FileSeek(&file, streamOffset);
+      if (res < 0) {
+        StopStream();
+        return res;
+      }
+      break;
+    }
+    if (res != 0) {
+      NRF_LOG_INFO("[FS_S] Read stream aborted: %d", res);
+      StopStream();
+      return 0;
+    }
+    streamOffset += resp.chunklen;
+    streamRemaining -= resp.chunklen;
+    finished = streamRemaining == 0;
+  }
+
+  if (!finished) {
+    ble_npl_callout_reset(&streamCallout, ConnectionInterval(streamConnection));
+    return 0;
+  }
+  StopStream();
+  if (streamOffset >= totalSize) {
+    CloseSession();
   }
   return 0;
 }
 
+void FSService::StopStream() {
+  if (!streamActive) {
+    return;
+  }
+  streamActive = false;
+  streamRemaining = 0;
+  ble_npl_callout_stop(&streamCallout);
+  systemTask.PushMessage(Pinetime::System::Messages::StopFileTransfer);
+}
+
+void FSService::SendReadError(uint16_t connectionHandle, uint32_t offset, int error) {
+  ReadResponse resp;
+  resp.command = commands::READ_DATA;
+  resp.status = (int8_t) error;
+  resp.chunkoff = offset;
+  resp.chunklen = 0;
+  resp.totallen = 0;
+  os_mbuf* om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
+  ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
+}
+
+TickType_t FSService::ConnectionInterval(uint16_t connectionHandle) {
+  ble_gap_conn_desc desc;
+  if (ble_gap_conn_find(connectionHandle, &desc) != 0) {
+    return 1;
+  }
+  // conn_itvl is expressed in units of 1.25ms
+  return std::max<TickType_t>(1, pdMS_TO_TICKS(desc.conn_itvl * 5 / 4));
+}
+
 int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
   auto command = static_cast<commands>(om->om_data[0]);
   NRF_LOG_INFO("[FS_S] -> FSCommandHandler Command %d", command);
@@ -71,7 +295,10 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
   }
   lfs_dir_t dir = {0};
   lfs_info info = {0};
-  lfs_file f = {0};
+  if (command != commands::READ_PACING && command != commands::WRITE_DATA) {
+    // Any other command ends the current transfer
+    CloseSession();
+  }
   switch (command) {
     case commands::READ: {
       NRF_LOG_INFO("[FS_S] -> Read");
@@ -82,62 +309,37 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       }
       memcpy(filepath, header->pathstr, plen);
       filepath[plen] = 0; // Copy and null terminate string
-      ReadResponse resp;
-      os_mbuf* om;
-      resp.command = commands::READ_DATA;
-      resp.status = 0x01;
-      resp.chunkoff = header->chunkoff;
       int res = fs.Stat(filepath, &info);
-      if (res == LFS_ERR_NOENT && info.type != LFS_TYPE_DIR) {
-        resp.status = (int8_t) res;
-        resp.chunklen = 0;
-        resp.totallen = 0;
-        om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
-      } else {
-        resp.chunklen = std::min(header->chunksize, info.size); // TODO add mtu somehow
-        resp.totallen = info.size;
-        fs.FileOpen(&f, filepath, LFS_O_RDONLY);
-        fs.FileSeek(&f, header->chunkoff);
-        uint8_t fileData[resp.chunklen] = {0};
-        resp.chunklen = fs.FileRead(&f, fileData, resp.chunklen);
-        om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
-        os_mbuf_append(om, fileData, resp.chunklen);
-        fs.FileClose(&f);
+      if (res == 0) {
+        res = OpenSession(FSState::READ);
+        fileSize = info.size;
+      }
+      if (res == 0) {
+        res = StreamRead(connectionHandle, header->chunkoff, header->chunksize);
+      }
+      if (res < 0) {
+        SendReadError(connectionHandle, header->chunkoff, res);
       }
-
-      ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
       break;
     }
     case commands::READ_PACING: {
       NRF_LOG_INFO("[FS_S] -> Readpacing");
       auto* header = (ReadHeader*) om->om_data;
-      ReadResponse resp;
-      resp.command = commands::READ_DATA;
-      resp.status = 0x01;
-      resp.chunkoff = header->chunkoff;
-      int res = fs.Stat(filepath, &info);
-      if (res == LFS_ERR_NOENT && info.type != LFS_TYPE_DIR) {
-        resp.status = (int8_t) res;
-        resp.chunklen = 0;
-        resp.totallen = 0;
-      } else {
-        resp.chunklen = std::min(header->chunksize, info.size); // TODO add mtu somehow
-        resp.totallen = info.size;
-        fs.FileOpen(&f, filepath, LFS_O_RDONLY);
-        fs.FileSeek(&f, header->chunkoff);
+      int res = 0;
+      if (state != FSState::READ) {
+        // The session timed out, reopen the file
+        res = fs.Stat(filepath, &info);
+        if (res == 0) {
+          res = OpenSession(FSState::READ);
+          fileSize = info.size;
+        }
       }
-      os_mbuf* om;
-      if (resp.chunklen > 0) {
-        uint8_t fileData[resp.chunklen] = {0};
-        resp.chunklen = fs.FileRead(&f, fileData, resp.chunklen);
-        om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
-        os_mbuf_append(om, fileData, resp.chunklen);
-      } else {
-        resp.chunklen = 0;
-        om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
+      if (res == 0) {
+        res = StreamRead(connectionHandle, header->chunkoff, header->chunksize);
+      }
+      if (res < 0) {
+        SendReadError(connectionHandle, header->chunkoff, res);
       }
-      fs.FileClose(&f);
-      ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
       break;
     }
     case commands::WRITE: {
@@ -155,12 +357,12 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       resp.offset = header->offset;
       resp.modTime = 0;
 
-      int res = fs.FileOpen(&f, filepath, LFS_O_RDWR | LFS_O_CREAT);
-      if (res == 0) {
-        fs.FileClose(&f);
-        resp.status = (res == 0) ? 0x01 : (int8_t) res;
-      }
-      resp.freespace = std::min(fs.getSize() - (fs.GetFSSize() * fs.getBlockSize()), fileSize - header->offset);
+      int res = OpenSession(FSState::WRITE);
+      resp.status = (res == 0) ? 0x01 : (int8_t) res;
+      stagingOffset = header->offset;
+      // Walking the whole filesystem is expensive, only do it once per transfer
+      freeSpace = fs.getSize() - (fs.GetFSSize() * fs.getBlockSize());
+      resp.freespace = std::min(freeSpace, fileSize - header->offset);
       auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(WriteResponse));
       ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
       break;
@@ -173,16 +375,18 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       resp.offset = header->offset;
       int res = 0;
 
-      if (!(res = fs.FileOpen(&f, filepath, LFS_O_RDWR | LFS_O_CREAT))) {
-        if ((res = fs.FileSeek(&f, header->offset)) >= 0) {
-          res = fs.FileWrite(&f, header->data, header->dataSize);
-        }
-        fs.FileClose(&f);
+      if (state != FSState::WRITE) {
+        // The session timed out, reopen the file
+        res = OpenSession(FSState::WRITE);
       }
-      if (res < 0) {
-        resp.status = (int8_t) res;
+      if (res == 0) {
+        res = StageWrite(header->offset, header->data, header->dataSize);
+      }
+      if (res == 0 && header->offset + header->dataSize >= static_cast<uint32_t>(fileSize)) {
+        res = CloseSession();
       }
-      resp.freespace = std::min(fs.getSize() - (fs.GetFSSize() * fs.getBlockSize()), fileSize - header->offset);
+      resp.status = (res < 0) ? (int8_t) res : 0x01;
+      resp.freespace = std::min(freeSpace, fileSize - header->offset);
       auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(WriteResponse));
       ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
       break;
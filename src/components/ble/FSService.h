@@ -1,7 +1,12 @@
 #pragma once
+#include <array>
+#include <FreeRTOS.h>
+#include <semphr.h>
 #define min // workaround: nimble's min/max macros conflict with libstdc++
 #define max
 #include <host/ble_gap.h>
+#include <host/ble_att.h>
+#include <nimble/nimble_npl.h>
 #undef max
 #undef min
 
@@ -22,6 +27,9 @@ namespace Pinetime {
 
       int OnFSServiceRequested(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context);
       void NotifyFSRaw(uint16_t connectionHandle);
+      // Ends the current transfer session, committing the file being written (on disconnection or timeout)
+      void Reset();
+      void OnStreamCallout();
 
     private:
       Pinetime::System::SystemTask& systemTask;
@@ -70,9 +78,31 @@ namespace Pinetime {
         READ = 0x01,
         WRITE = 0x02,
       };
-      FSState state;
+      // Transfer session: the file stays open across the chunks of a READ or WRITE transfer, and is
+      // only closed (which commits it to flash) once the transfer completes, times out, the client
+      // disconnects or sends another command.
+      FSState state = FSState::IDLE;
       char filepath[maxpathlen]; // TODO ..ugh fixed filepath len
       int fileSize;
+      lfs_file_t file;
+      size_t freeSpace = 0;
+      SemaphoreHandle_t sessionMutex;
+      ble_npl_callout sessionCallout = {};
+      static constexpr TickType_t sessionTimeout = pdMS_TO_TICKS(5000);
+      // Written chunks are gathered here and written to the file one flash page at a time
+      alignas(4) std::array<uint8_t, 256> staging;
+      uint32_t stagingOffset = 0;
+      uint32_t stagingSize = 0;
+      // Read data is streamed in as many notifications as the ATT MTU requires, leaving a few
+      // mbufs free for the rest of the stack. At most maxBatchSize notifications are queued at once,
+      // the rest of the chunk is sent from streamCallout (on the host task) once mbufs are released.
+      static constexpr int minFreeBuffers = 4;
+      static constexpr int maxBatchSize = 4;
+      uint16_t streamConnection = BLE_HS_CONN_HANDLE_NONE;
+      uint32_t streamOffset = 0;
+      uint32_t streamRemaining = 0;
+      bool streamActive = false;
+      ble_npl_callout streamCallout = {};
 
       using ReadHeader = struct __attribute__((packed)) {
         commands command;
@@ -191,6 +221,15 @@ namespace Pinetime {
       };
 
       int FSCommandHandler(uint16_t connectionHandle, os_mbuf* om);
+      int OpenSession(FSState mode);
+      int CloseSession();
+      int StageWrite(uint32_t offset, const uint8_t* data, uint32_t size);
+      int FlushStaging();
+      int StreamRead(uint16_t connectionHandle, uint32_t offset, uint32_t size);
+      int ContinueStream();
+      void StopStream();
+      void SendReadError(uint16_t connectionHandle, uint32_t offset, int error);
+      TickType_t ConnectionInterval(uint16_t connectionHandle);
       void prepareReadDataResp(ReadHeader* header, ReadResponse* resp);
     };
   }
@@ -2,6 +2,7 @@
 #include "components/motion/MotionController.h"
 #include "components/ble/NimbleController.h"
 #include <nrf_log.h>
+#include <algorithm>
 
 using namespace Pinetime::Controllers;
 
@@ -20,6 +21,26 @@ namespace {
   constexpr ble_uuid128_t motionServiceUuid {BaseUuid()};
   constexpr ble_uuid128_t stepCountCharUuid {CharUuid(0x01, 0x00)};
   constexpr ble_uuid128_t motionValuesCharUuid {CharUuid(0x02, 0x00)};
+  constexpr ble_uuid128_t motionStreamCharUuid {CharUuid(0x03, 0x00)};
+  constexpr ble_uuid128_t motionStreamConfigCharUuid {CharUuid(0x04, 0x00)};
+
+  uint32_t TicksToMilliseconds(TickType_t ticks) {
+    return static_cast<uint32_t>(static_cast<uint64_t>(ticks) * 1000 / configTICK_RATE_HZ);
+  }
+
+  void Put16(uint8_t* buffer, uint16_t value) {
+    buffer[0] = value & 0xff;
+    buffer[1] = value >> 8;
+  }
+
+  void Put32(uint8_t* buffer, uint32_t value) {
+    Put16(&buffer[0], value & 0xffff);
+    Put16(&buffer[2], value >> 16);
+  }
+
+  bool FitsInt8(int32_t value) {
+    return value >= INT8_MIN && value <= INT8_MAX;
+  }
 
   int MotionServiceCallback(uint16_t /*conn_handle*/, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt, void* arg) {
     auto* motionService = static_cast<MotionService*>(arg);
@@ -41,6 +62,16 @@ MotionService::MotionService(NimbleController& nimble, Controllers::MotionContro
                                .arg = this,
                                .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY,
                                .val_handle = &motionValuesHandle},
+                              {.uuid = &motionStreamCharUuid.u,
+                               .access_cb = MotionServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_NOTIFY,
+                               .val_handle = &motionStreamHandle},
+                              {.uuid = &motionStreamConfigCharUuid.u,
+                               .access_cb = MotionServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_WRITE,
+                               .val_handle = &motionStreamConfigHandle},
                               {0}},
     serviceDefinition {
       {.type = BLE_GATT_SVC_TYPE_PRIMARY, .uuid = &motionServiceUuid.u, .characteristics = characteristicDefinition},
@@ -71,10 +102,30 @@ int MotionService::OnStepCountRequested(uint16_t attributeHandle, ble_gatt_acces
 
     int res = os_mbuf_append(context->om, buffer, 3 * sizeof(int16_t));
     return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+  } else if (attributeHandle == motionStreamConfigHandle) {
+    return OnStreamConfigRequested(context);
   }
   return 0;
 }
 
+int MotionService::OnStreamConfigRequested(ble_gatt_access_ctxt* context) {
+  if (context->op == BLE_GATT_ACCESS_OP_WRITE_CHR) {
+    StreamConfig config;
+    if (OS_MBUF_PKTLEN(context->om) != sizeof(StreamConfig) || os_mbuf_copydata(context->om, 0, sizeof(StreamConfig), &config) != 0) {
+      return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+    }
+    NRF_LOG_INFO("Motion-stream : period = %d, latency = %d, flags = %d", config.samplePeriod, config.maxLatency, config.flags);
+    streamSamplePeriod = config.samplePeriod;
+    streamMaxLatency = config.maxLatency;
+    streamFlags = config.flags & streamFlagDeltaEncoding;
+    return 0;
+  }
+
+  StreamConfig config {streamSamplePeriod, streamMaxLatency, streamFlags};
+  int res = os_mbuf_append(context->om, &config, sizeof(StreamConfig));
+  return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+}
+
 void MotionService::OnNewStepCountValue(uint32_t stepCount) {
   if (!stepCountNoficationEnabled)
     return;
@@ -107,11 +158,111 @@ void MotionService::OnNewMotionValues(int16_t x, int16_t y, int16_t z) {
   ble_gattc_notify_custom(connectionHandle, motionValuesHandle, om);
 }
 
+void MotionService::OnNewMotionSamples(std::span<const Drivers::Bma421::Sample> samples, TickType_t time) {
+  uint16_t connectionHandle = nimble.connHandle();
+  if (!motionStreamNotificationEnabled || connectionHandle == 0 || connectionHandle == BLE_HS_CONN_HANDLE_NONE) {
+    streamPacketSize = 0;
+    streamHasLastSample = false;
+    return;
+  }
+
+  const size_t payloadSize = std::min(static_cast<size_t>(ble_att_mtu(connectionHandle) - 3), streamPacket.size());
+  const uint32_t samplePeriod = streamSamplePeriod;
+  const uint32_t now = TicksToMilliseconds(time);
+
+  for (size_t i = 0; i < samples.size(); i++) {
+    // The samples of a batch come from the FIFO at its nominal rate, the last one being the most recent
+    uint32_t timestamp = now - (samples.size() - 1 - i) * Drivers::Bma421::fifoSamplePeriod;
+    if (streamHasLastSample && static_cast<int32_t>(timestamp - streamLastTime) < 0) {
+      // Jitter on the read time: keep the timestamps monotonic
+      timestamp = streamLastTime;
+    }
+    if (streamHasLastSample && timestamp - streamLastTime < samplePeriod) {
+      continue;
+    }
+    if (!AppendStreamSample(samples[i], timestamp, payloadSize)) {
+      SendStreamPacket();
+      AppendStreamSample(samples[i], timestamp, payloadSize);
+    }
+  }
+
+  if (streamPacketSize > 0 && now - streamPacketTime >= streamMaxLatency) {
+    SendStreamPacket();
+  }
+}
+
+bool MotionService::AppendStreamSample(const Drivers::Bma421::Sample& sample, uint32_t timestamp, size_t payloadSize) {
+  const uint8_t flags = streamFlags;
+  const bool deltaEncoding = (flags & streamFlagDeltaEncoding) != 0;
+  uint8_t* data = &streamPacket[streamPacketSize];
+
+  if (streamPacketSize == 0) {
+    // Header: flags, sample count and timestamp of the first sample, which is always stored in full
+    streamPacket[0] = flags;
+    streamPacket[1] = 0;
+    Put32(&streamPacket[2], timestamp);
+    streamPacketTime = timestamp;
+    data = &streamPacket[streamHeaderSize];
+    if (!deltaEncoding) {
+      Put16(data, 0);
+      data += 2;
+    }
+    Put16(&data[0], sample.x);
+    Put16(&data[2], sample.y);
+    Put16(&data[4], sample.z);
+    data += 6;
+  } else if (streamPacket[0] != flags) {
+    // The configuration changed, the next sample starts a new packet
+    return false;
+  } else if (deltaEncoding) {
+    const uint32_t timeDelta = timestamp - streamLastTime;
+    const int32_t dx = sample.x - streamLastSample.x;
+    const int32_t dy = sample.y - streamLastSample.y;
+    const int32_t dz = sample.z - streamLastSample.z;
+    if (streamPacketSize + 4 > payloadSize || timeDelta > UINT8_MAX || !FitsInt8(dx) || !FitsInt8(dy) || !FitsInt8(dz)) {
+      return false;
+    }
+    data[0] = static_cast<uint8_t>(timeDelta);
+    data[1] = static_cast<int8_t>(dx);
+    data[2] = static_cast<int8_t>(dy);
+    data[3] = static_cast<int8_t>(dz);
+    data += 4;
+  } else {
+    const uint32_t timeOffset = timestamp - streamPacketTime;
+    if (streamPacketSize + 8 > payloadSize || timeOffset > UINT16_MAX) {
+      return false;
+    }
+    Put16(&data[0], timeOffset);
+    Put16(&data[2], sample.x);
+    Put16(&data[4], sample.y);
+    Put16(&data[6], sample.z);
+    data += 8;
+  }
+
+  streamPacket[1]++;
+  streamPacketSize = data - streamPacket.data();
+  streamLastSample = sample;
+  streamLastTime = timestamp;
+  streamHasLastSample = true;
+  return true;
+}
+
+void MotionService::SendStreamPacket() {
+  uint16_t connectionHandle = nimble.connHandle();
+  if (streamPacketSize > 0 && connectionHandle != 0 && connectionHandle != BLE_HS_CONN_HANDLE_NONE) {
+    auto* om = ble_hs_mbuf_from_flat(streamPacket.data(), streamPacketSize);
+    ble_gattc_notify_custom(connectionHandle, motionStreamHandle, om);
+  }
+  streamPacketSize = 0;
+}
+
 void MotionService::SubscribeNotification(uint16_t attributeHandle) {
   if (attributeHandle == stepCountHandle)
     stepCountNoficationEnabled = true;
   else if (attributeHandle == motionValuesHandle)
     motionValuesNoficationEnabled = true;
+  else if (attributeHandle == motionStreamHandle)
+    motionStreamNotificationEnabled = true;
 }
 
 void MotionService::UnsubscribeNotification(uint16_t attributeHandle) {
@@ -119,8 +270,10 @@ void MotionService::UnsubscribeNotification(uint16_t attributeHandle) {
     stepCountNoficationEnabled = false;
   else if (attributeHandle == motionValuesHandle)
     motionValuesNoficationEnabled = false;
+  else if (attributeHandle == motionStreamHandle)
+    motionStreamNotificationEnabled = false;
 }
 
 bool MotionService::IsMotionNotificationSubscribed() const {
-  return motionValuesNoficationEnabled;
+  return motionValuesNoficationEnabled || motionStreamNotificationEnabled;
 }
@@ -3,8 +3,12 @@
 #define max
 #include <host/ble_gap.h>
 #include <atomic>
+#include <array>
+#include <span>
 #undef max
 #undef min
+#include <FreeRTOS.h>
+#include "drivers/Bma421.h"
 
 namespace Pinetime {
   namespace Controllers {
@@ -18,22 +22,54 @@ namespace Pinetime {
       int OnStepCountRequested(uint16_t attributeHandle, ble_gatt_access_ctxt* context);
       void OnNewStepCountValue(uint32_t stepCount);
       void OnNewMotionValues(int16_t x, int16_t y, int16_t z);
+      // Samples drained from the sensor in one batch, oldest first. The last one was read at the given tick count.
+      void OnNewMotionSamples(std::span<const Drivers::Bma421::Sample> samples, TickType_t time);
 
       void SubscribeNotification(uint16_t attributeHandle);
       void UnsubscribeNotification(uint16_t attributeHandle);
       bool IsMotionNotificationSubscribed() const;
 
     private:
+      using StreamConfig = struct __attribute__((packed)) {
+        uint16_t samplePeriod;
+        uint16_t maxLatency;
+        uint8_t flags;
+      };
+
+      static constexpr uint8_t streamFlagDeltaEncoding = 0x01;
+      static constexpr size_t streamHeaderSize = 6;
+      static constexpr size_t streamMaxPayloadSize = MYNEWT_VAL(BLE_ATT_PREFERRED_MTU) - 3;
+
+      int OnStreamConfigRequested(ble_gatt_access_ctxt* context);
+      bool AppendStreamSample(const Drivers::Bma421::Sample& sample, uint32_t timestamp, size_t payloadSize);
+      void SendStreamPacket();
+
       NimbleController& nimble;
       Controllers::MotionController& motionController;
 
-      struct ble_gatt_chr_def characteristicDefinition[3];
+      struct ble_gatt_chr_def characteristicDefinition[5];
       struct ble_gatt_svc_def serviceDefinition[2];
 
       uint16_t stepCountHandle;
       uint16_t motionValuesHandle;
+      uint16_t motionStreamHandle;
+      uint16_t motionStreamConfigHandle;
       std::atomic_bool stepCountNoficationEnabled {false};
       std::atomic_bool motionValuesNoficationEnabled {false};
+      std::atomic_bool motionStreamNotificationEnabled {false};
+
+      // Written by the BLE host through the stream configuration characteristic
+      std::atomic<uint16_t> streamSamplePeriod {0};
+      std::atomic<uint16_t> streamMaxLatency {1000};
+      std::atomic<uint8_t> streamFlags {0};
+
+      // Packet being filled, only accessed from SystemTask
+      std::array<uint8_t, streamMaxPayloadSize> streamPacket;
+      size_t streamPacketSize = 0;
+      uint32_t streamPacketTime = 0;
+      uint32_t streamLastTime = 0;
+      Drivers::Bma421::Sample streamLastSample {};
+      bool streamHasLastSample = false;
     };
   }
 }
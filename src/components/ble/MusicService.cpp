@@ -20,6 +20,7 @@
 #include <cstring>
 #include <FreeRTOS.h>
 #include <task.h>
+#include "utility/ChangeBus.h"
 
 namespace {
   // 0000yyxx-78fc-48fe-8e23-433b3a1942d0
@@ -175,6 +176,7 @@ int Pinetime::Controllers::MusicService::OnCommand(struct ble_gatt_access_ctxt*
     } else if (ble_uuid_cmp(ctxt->chr->uuid, &msPlaybackSpeedCharUuid.u) == 0) {
       playbackSpeed = static_cast<float>(((s[0] << 24) | (s[1] << 16) | (s[2] << 8) | s[3])) / 100.0f;
     }
+    Utility::ChangeBus::Publish(Utility::Topic::Music);
   }
   return 0;
 }
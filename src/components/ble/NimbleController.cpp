@@ -98,6 +98,9 @@ void NimbleController::Init() {
   heartRateService.Init();
   motionService.Init();
   fsService.Init();
+#ifdef RUNTIME_STATS
+  runTimeStatsService.Init();
+#endif
 
   int rc;
   rc = ble_hs_util_ensure_addr(0);
@@ -223,6 +226,7 @@ int NimbleController::OnGAPEvent(ble_gap_event* event) {
 
       currentTimeClient.Reset();
       alertNotificationClient.Reset();
+      fsService.Reset();
       connectionHandle = BLE_HS_CONN_HANDLE_NONE;
       if (bleController.IsConnected()) {
         bleController.Disconnect();
@@ -21,6 +21,7 @@
 #include "components/ble/NavigationService.h"
 #include "components/ble/ServiceDiscovery.h"
 #include "components/ble/MotionService.h"
+#include "components/ble/RunTimeStatsService.h"
 #include "components/ble/SimpleWeatherService.h"
 #include "components/fs/FS.h"
 
@@ -106,6 +107,9 @@ namespace Pinetime {
       HeartRateService heartRateService;
       MotionService motionService;
       FSService fsService;
+#ifdef RUNTIME_STATS
+      RunTimeStatsService runTimeStatsService;
+#endif
       ServiceDiscovery serviceDiscovery;
 
       uint8_t addrType;
@@ -2,24 +2,60 @@
 #include <cstring>
 #include <algorithm>
 #include <cassert>
+#include "utility/ChangeBus.h"
 
 using namespace Pinetime::Controllers;
 
 constexpr uint8_t NotificationManager::MessageSize;
 
-void NotificationManager::Push(NotificationManager::Notification&& notif) {
-  notif.id = GetNextId();
-  notif.valid = true;
-  newNotification = true;
+NotificationManager::NotificationManager() {
+  mutex = xSemaphoreCreateMutex();
+}
+
+char* NotificationManager::Reserve(size_t messageSize) {
+  messageSize = std::min(messageSize, MaximumMessageSize());
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  if (IsEmpty()) {
+    writeOffset = 0;
+  }
+  // Messages are never split, so that views can point straight into the storage
+  if (writeOffset + messageSize > storage.size()) {
+    writeOffset = 0;
+  }
+  // Messages are written in order around the ring, so the ones in the way are always the oldest ones
+  while (!IsEmpty() && (size == TotalNbNotifications || Overlaps(writeOffset, messageSize))) {
+    DismissIdx(size - 1);
+  }
+  return storage.data() + writeOffset;
+}
+
+void NotificationManager::Commit(Categories category, size_t messageSize) {
+  messageSize = std::min(messageSize, MaximumMessageSize());
+  if (messageSize == 0) {
+    xSemaphoreGive(mutex);
+    return;
+  }
+  storage[writeOffset + messageSize - 1] = '\0';
+
   if (beginIdx > 0) {
     --beginIdx;
   } else {
-    beginIdx = notifications.size() - 1;
+    beginIdx = slots.size() - 1;
   }
-  notifications[beginIdx] = std::move(notif);
-  if (size < notifications.size()) {
+  slots[beginIdx] = {GetNextId(), category, static_cast<uint16_t>(writeOffset), static_cast<uint16_t>(messageSize)};
+  writeOffset += messageSize;
+  if (size < slots.size()) {
     size++;
   }
+  xSemaphoreGive(mutex);
+  newNotification = true;
+  Utility::ChangeBus::Publish(Utility::Topic::Notifications);
+}
+
+void NotificationManager::Push(Categories category, const char* message, size_t messageSize) {
+  messageSize = std::min(messageSize, MaximumMessageSize());
+  std::memcpy(Reserve(messageSize), message, messageSize);
+  Commit(category, messageSize);
 }
 
 NotificationManager::Notification::Id NotificationManager::GetNextId() {
@@ -27,34 +63,64 @@ NotificationManager::Notification::Id NotificationManager::GetNextId() {
 }
 
 NotificationManager::Notification NotificationManager::GetLastNotification() const {
-  if (this->IsEmpty()) {
-    return {};
+  Notification notification;
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  if (!this->IsEmpty()) {
+    notification = this->View(0);
   }
-  return this->At(0);
+  xSemaphoreGive(mutex);
+  return notification;
 }
 
-const NotificationManager::Notification& NotificationManager::At(NotificationManager::Notification::Idx idx) const {
-  if (idx >= notifications.size()) {
+const NotificationManager::Slot& NotificationManager::At(NotificationManager::Notification::Idx idx) const {
+  if (idx >= slots.size()) {
     assert(false);
-    return notifications.at(beginIdx); // this should not happen
+    return slots.at(beginIdx); // this should not happen
   }
-  size_t read_idx = (beginIdx + idx) % notifications.size();
-  return notifications.at(read_idx);
+  size_t read_idx = (beginIdx + idx) % slots.size();
+  return slots.at(read_idx);
 }
 
-NotificationManager::Notification& NotificationManager::At(NotificationManager::Notification::Idx idx) {
-  if (idx >= notifications.size()) {
+NotificationManager::Slot& NotificationManager::At(NotificationManager::Notification::Idx idx) {
+  if (idx >= slots.size()) {
     assert(false);
-    return notifications.at(beginIdx); // this should not happen
+    return slots.at(beginIdx); // this should not happen
+  }
+  size_t read_idx = (beginIdx + idx) % slots.size();
+  return slots.at(read_idx);
+}
+
+NotificationManager::Notification NotificationManager::View(NotificationManager::Notification::Idx idx) const {
+  const Slot& slot = this->At(idx);
+  Notification notification;
+  notification.size = slot.size;
+  notification.category = slot.category;
+  notification.id = slot.id;
+  notification.valid = true;
+  return notification;
+}
+
+bool NotificationManager::Overlaps(size_t offset, size_t length) const {
+  for (NotificationManager::Notification::Idx idx = 0; idx < this->size; idx++) {
+    const Slot& slot = this->At(idx);
+    if (slot.offset < offset + length && offset < static_cast<size_t>(slot.offset + slot.size)) {
+      return true;
+    }
   }
-  size_t read_idx = (beginIdx + idx) % notifications.size();
-  return notifications.at(read_idx);
+  return false;
 }
 
 NotificationManager::Notification::Idx NotificationManager::IndexOf(NotificationManager::Notification::Id id) const {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  NotificationManager::Notification::Idx idx = this->Find(id);
+  xSemaphoreGive(mutex);
+  return idx;
+}
+
+NotificationManager::Notification::Idx NotificationManager::Find(NotificationManager::Notification::Id id) const {
   for (NotificationManager::Notification::Idx idx = 0; idx < this->size; idx++) {
-    const NotificationManager::Notification& notification = this->At(idx);
-    if (notification.id == id) {
+    const Slot& slot = this->At(idx);
+    if (slot.id == id) {
       return idx;
     }
   }
@@ -62,33 +128,53 @@ NotificationManager::Notification::Idx NotificationManager::IndexOf(Notification
 }
 
 NotificationManager::Notification NotificationManager::Get(NotificationManager::Notification::Id id) const {
-  NotificationManager::Notification::Idx idx = this->IndexOf(id);
-  if (idx == this->size) {
-    return {};
+  Notification notification;
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  NotificationManager::Notification::Idx idx = this->Find(id);
+  if (idx != this->size) {
+    notification = this->View(idx);
   }
-  return this->At(idx);
+  xSemaphoreGive(mutex);
+  return notification;
 }
 
 NotificationManager::Notification NotificationManager::GetNext(NotificationManager::Notification::Id id) const {
-  NotificationManager::Notification::Idx idx = this->IndexOf(id);
-  if (idx == this->size) {
-    return {};
+  Notification notification;
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  NotificationManager::Notification::Idx idx = this->Find(id);
+  if (idx != this->size && idx != 0) {
+    notification = this->View(idx - 1);
   }
-  if (idx == 0 || idx > notifications.size()) {
-    return {};
-  }
-  return this->At(idx - 1);
+  xSemaphoreGive(mutex);
+  return notification;
 }
 
 NotificationManager::Notification NotificationManager::GetPrevious(NotificationManager::Notification::Id id) const {
-  NotificationManager::Notification::Idx idx = this->IndexOf(id);
-  if (idx == this->size) {
-    return {};
+  Notification notification;
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  NotificationManager::Notification::Idx idx = this->Find(id);
+  if (idx != this->size && static_cast<size_t>(idx + 1) < this->size) {
+    notification = this->View(idx + 1);
   }
-  if (static_cast<size_t>(idx + 1) >= notifications.size()) {
-    return {};
+  xSemaphoreGive(mutex);
+  return notification;
+}
+
+size_t NotificationManager::CopyMessage(NotificationManager::Notification::Id id, char* buffer, size_t bufferSize) const {
+  if (bufferSize == 0) {
+    return 0;
+  }
+  size_t copied = 0;
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  NotificationManager::Notification::Idx idx = this->Find(id);
+  if (idx != this->size) {
+    const Slot& slot = this->At(idx);
+    copied = std::min<size_t>(slot.size, bufferSize);
+    std::memcpy(buffer, storage.data() + slot.offset, copied);
+    buffer[copied - 1] = '\0';
   }
-  return this->At(idx + 1);
+  xSemaphoreGive(mutex);
+  return copied;
 }
 
 void NotificationManager::DismissIdx(NotificationManager::Notification::Idx idx) {
@@ -99,25 +185,28 @@ void NotificationManager::DismissIdx(NotificationManager::Notification::Idx idx)
     assert(false);
     return; // this should not happen
   }
+  // Only the headers move, the message bytes are reclaimed when the writer wraps around to them
   if (idx == 0) { // just remove the first element, don't need to change the other elements
-    notifications.at(beginIdx).valid = false;
-    beginIdx = (beginIdx + 1) % notifications.size();
+    beginIdx = (beginIdx + 1) % slots.size();
   } else {
-    // overwrite the specified entry by moving all later messages one index to the front
+    // overwrite the specified entry by moving all later headers one index to the front
     for (size_t i = idx; i < size - 1; ++i) {
       this->At(i) = this->At(i + 1);
     }
-    this->At(size - 1).valid = false;
   }
   --size;
 }
 
 void NotificationManager::Dismiss(NotificationManager::Notification::Id id) {
-  NotificationManager::Notification::Idx idx = this->IndexOf(id);
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  NotificationManager::Notification::Idx idx = this->Find(id);
   if (idx == this->size) {
+    xSemaphoreGive(mutex);
     return;
   }
   this->DismissIdx(idx);
+  xSemaphoreGive(mutex);
+  Utility::ChangeBus::Publish(Utility::Topic::Notifications);
 }
 
 bool NotificationManager::AreNewNotificationsAvailable() const {
@@ -125,26 +214,41 @@ bool NotificationManager::AreNewNotificationsAvailable() const {
 }
 
 bool NotificationManager::ClearNewNotificationFlag() {
-  return newNotification.exchange(false);
+  bool wasSet = newNotification.exchange(false);
+  if (wasSet) {
+    Utility::ChangeBus::Publish(Utility::Topic::Notifications);
+  }
+  return wasSet;
 }
 
 size_t NotificationManager::NbNotifications() const {
-  return size;
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  size_t nbNotifications = size;
+  xSemaphoreGive(mutex);
+  return nbNotifications;
 }
 
-const char* NotificationManager::Notification::Message() const {
-  const char* itField = std::find(message.begin(), message.begin() + size - 1, '\0');
-  if (itField != message.begin() + size - 1) {
+const char* NotificationManager::Message(const char* text, size_t textSize) {
+  if (textSize == 0) {
+    return "";
+  }
+  const char* end = text + textSize - 1;
+  const char* itField = std::find(text, end, '\0');
+  if (itField != end) {
     const char* ptr = (itField) + 1;
     return ptr;
   }
-  return const_cast<char*>(message.data());
+  return text;
 }
 
-const char* NotificationManager::Notification::Title() const {
-  const char* itField = std::find(message.begin(), message.begin() + size - 1, '\0');
-  if (itField != message.begin() + size - 1) {
-    return message.data();
+const char* NotificationManager::Title(const char* text, size_t textSize) {
+  if (textSize == 0) {
+    return {};
+  }
+  const char* end = text + textSize - 1;
+  const char* itField = std::find(text, end, '\0');
+  if (itField != end) {
+    return text;
   }
   return {};
 }
@@ -4,12 +4,14 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <FreeRTOS.h>
+#include <semphr.h>
 
 namespace Pinetime {
   namespace Controllers {
     class NotificationManager {
     public:
-      enum class Categories {
+      enum class Categories : uint8_t {
         Unknown,
         SimpleAlert,
         Email,
@@ -22,29 +24,41 @@ namespace Pinetime {
         HighProriotyAlert,
         InstantMessage
       };
-      static constexpr uint8_t MessageSize {100};
+      // Including the string terminator. This is the payload of a single ANS write at the preferred ATT MTU (256 - 3 - 3).
+      static constexpr uint8_t MessageSize {250};
 
+      // Handle on a notification stored in the manager. It doesn't hold the text, which is only copied by CopyMessage().
       struct Notification {
         using Id = uint8_t;
         using Idx = uint8_t;
 
-        std::array<char, MessageSize + 1> message{};
-        uint8_t size;
+        uint16_t size = 0;
         Categories category = Categories::Unknown;
         Id id = 0;
         bool valid = false;
-
-        const char* Message() const;
-        const char* Title() const;
       };
 
-      void Push(Notification&& notif);
+      NotificationManager();
+
+      // Returns room for a message of up to size bytes, dropping the oldest notifications if needed. The message
+      // is written in place and published with Commit(). The manager stays locked in between, so Commit() must
+      // always follow (with a size of 0 to drop the message).
+      char* Reserve(size_t size);
+      void Commit(Categories category, size_t size);
+      void Push(Categories category, const char* message, size_t size);
+
       Notification GetLastNotification() const;
       Notification Get(Notification::Id id) const;
       Notification GetNext(Notification::Id id) const;
       Notification GetPrevious(Notification::Id id) const;
       // Return the index of the notification with the specified id, if not found return NbNotifications()
       Notification::Idx IndexOf(Notification::Id id) const;
+      // Copies the text of the notification (title and message separated by '\0') into buffer, under the lock.
+      // Returns the number of bytes copied, including the terminator, or 0 if the notification was dismissed.
+      size_t CopyMessage(Notification::Id id, char* buffer, size_t bufferSize) const;
+      // Split the text copied by CopyMessage()
+      static const char* Title(const char* text, size_t textSize);
+      static const char* Message(const char* text, size_t textSize);
       bool ClearNewNotificationFlag();
       bool AreNewNotificationsAvailable() const;
       void Dismiss(Notification::Id id);
@@ -53,25 +67,42 @@ namespace Pinetime {
         return MessageSize;
       };
 
-      bool IsEmpty() const {
-        return size == 0;
-      }
-
       size_t NbNotifications() const;
 
     private:
+      // Packed header describing one message in the storage ring
+      struct Slot {
+        Notification::Id id;
+        Categories category;
+        uint16_t offset;
+        uint16_t size;
+      };
+      static_assert(sizeof(Slot) == 6, "Notification slots should stay packed");
+
       Notification::Id nextId {0};
       Notification::Id GetNextId();
-      const Notification& At(Notification::Idx idx) const;
-      Notification& At(Notification::Idx idx);
+      // The helpers below expect the caller to hold the lock
+      bool IsEmpty() const {
+        return size == 0;
+      }
+      Notification::Idx Find(Notification::Id id) const;
+      const Slot& At(Notification::Idx idx) const;
+      Slot& At(Notification::Idx idx);
+      Notification View(Notification::Idx idx) const;
+      bool Overlaps(size_t offset, size_t length) const;
       void DismissIdx(Notification::Idx idx);
 
-      static constexpr uint8_t TotalNbNotifications = 5;
-      std::array<Notification, TotalNbNotifications> notifications;
+      static constexpr uint8_t TotalNbNotifications = 12;
+      static constexpr size_t StorageSize = 512;
+      std::array<Slot, TotalNbNotifications> slots;
+      std::array<char, StorageSize> storage;
+      size_t writeOffset = 0;                     // where the next message is written in storage
       size_t beginIdx = TotalNbNotifications - 1; // index of the newest notification
       size_t size = 0;                            // number of valid notifications in buffer
 
       std::atomic<bool> newNotification {false};
+      // The ring is written by the BLE host task and read by the display task
+      SemaphoreHandle_t mutex;
     };
   }
 }
@@ -0,0 +1,76 @@
+#include "components/ble/RunTimeStatsService.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <cstring>
+
+using namespace Pinetime::Controllers;
+
+namespace {
+  // 0006yyxx-78fc-48fe-8e23-433b3a1942d0
+  constexpr ble_uuid128_t CharUuid(uint8_t x, uint8_t y) {
+    return ble_uuid128_t {.u = {.type = BLE_UUID_TYPE_128},
+                          .value = {0xd0, 0x42, 0x19, 0x3a, 0x3b, 0x43, 0x23, 0x8e, 0xfe, 0x48, 0xfc, 0x78, x, y, 0x06, 0x00}};
+  }
+
+  // 00060000-78fc-48fe-8e23-433b3a1942d0
+  constexpr ble_uuid128_t BaseUuid() {
+    return CharUuid(0x00, 0x00);
+  }
+
+  constexpr ble_uuid128_t runTimeStatsServiceUuid {BaseUuid()};
+  constexpr ble_uuid128_t statsCharUuid {CharUuid(0x01, 0x00)};
+
+  struct __attribute__((packed)) TaskEntry {
+    uint8_t number;
+    char name[4];
+    uint32_t runTime;
+  };
+
+  int RunTimeStatsServiceCallback(uint16_t /*conn_handle*/, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt, void* arg) {
+    auto* runTimeStatsService = static_cast<RunTimeStatsService*>(arg);
+    return runTimeStatsService->OnStatsRequested(attr_handle, ctxt);
+  }
+}
+
+RunTimeStatsService::RunTimeStatsService()
+  : characteristicDefinition {{.uuid = &statsCharUuid.u,
+                               .access_cb = RunTimeStatsServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_READ,
+                               .val_handle = &statsHandle},
+                              {0}},
+    serviceDefinition {
+      {.type = BLE_GATT_SVC_TYPE_PRIMARY, .uuid = &runTimeStatsServiceUuid.u, .characteristics = characteristicDefinition},
+      {0},
+    } {
+}
+
+void RunTimeStatsService::Init() {
+  int res = 0;
+  res = ble_gatts_count_cfg(serviceDefinition);
+  ASSERT(res == 0);
+
+  res = ble_gatts_add_svcs(serviceDefinition);
+  ASSERT(res == 0);
+}
+
+int RunTimeStatsService::OnStatsRequested(uint16_t attributeHandle, ble_gatt_access_ctxt* context) {
+  if (attributeHandle != statsHandle) {
+    return 0;
+  }
+
+  // Long reads call this again for each part, NimBLE skips what was already sent
+  RunTimeStats_t stats;
+  vPortGetRunTimeStats(&stats);
+  int res = os_mbuf_append(context->om, &stats, sizeof(stats));
+
+  static constexpr UBaseType_t maxTaskCount = 10;
+  TaskStatus_t tasksStatus[maxTaskCount];
+  auto nb = uxTaskGetSystemState(tasksStatus, maxTaskCount, nullptr);
+  for (UBaseType_t i = 0; i < nb && res == 0; i++) {
+    TaskEntry entry {static_cast<uint8_t>(tasksStatus[i].xTaskNumber), {}, tasksStatus[i].ulRunTimeCounter};
+    strncpy(entry.name, tasksStatus[i].pcTaskName, sizeof(entry.name));
+    res = os_mbuf_append(context->om, &entry, sizeof(entry));
+  }
+  return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+}
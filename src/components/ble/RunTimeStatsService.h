@@ -0,0 +1,25 @@
+#pragma once
+#define min // workaround: nimble's min/max macros conflict with libstdc++
+#define max
+#include <host/ble_gap.h>
+#undef max
+#undef min
+
+namespace Pinetime {
+  namespace Controllers {
+    // Exports the FreeRTOS run-time statistics (RUNTIME_STATS build option), see doc/RunTimeStatsService.md
+    class RunTimeStatsService {
+    public:
+      RunTimeStatsService();
+      void Init();
+
+      int OnStatsRequested(uint16_t attributeHandle, ble_gatt_access_ctxt* context);
+
+    private:
+      struct ble_gatt_chr_def characteristicDefinition[2];
+      struct ble_gatt_svc_def serviceDefinition[2];
+
+      uint16_t statsHandle;
+    };
+  }
+}
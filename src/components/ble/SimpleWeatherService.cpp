@@ -22,6 +22,7 @@
 #include <array>
 #include <cstring>
 #include <nrf_log.h>
+#include "utility/ChangeBus.h"
 
 using namespace Pinetime::Controllers;
 
@@ -103,6 +104,7 @@ int SimpleWeatherService::OnCommand(struct ble_gatt_access_ctxt* ctxt) {
                      currentWeather->maxTemperature.PreciseCelsius(),
                      currentWeather->iconId,
                      currentWeather->location.data());
+        Utility::ChangeBus::Publish(Utility::Topic::Weather);
       }
       break;
     case MessageType::Forecast:
@@ -116,6 +118,7 @@ int SimpleWeatherService::OnCommand(struct ble_gatt_access_ctxt* ctxt) {
                        forecast->days[i]->maxTemperature.PreciseCelsius(),
                        forecast->days[i]->iconId);
         }
+        Utility::ChangeBus::Publish(Utility::Topic::Weather);
       }
       break;
     default:
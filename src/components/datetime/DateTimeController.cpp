@@ -2,7 +2,9 @@
 #include <libraries/log/nrf_log.h>
 #include <systemtask/SystemTask.h>
 #include <hal/nrf_rtc.h>
+#include <ctime>
 #include "nrf_assert.h"
+#include "utility/ChangeBus.h"
 
 using namespace Pinetime::Controllers;
 
@@ -15,6 +17,9 @@ namespace {
   constexpr const char* const MonthsStringLow[] =
     {"--", "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
 
+  constexpr uint16_t DaysBeforeMonth[] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+  constexpr int64_t secondsPerDay = 24 * 60 * 60;
+
   constexpr int compileTimeAtoi(const char* str) {
     int result = 0;
     while (*str >= '0' && *str <= '9') {
@@ -35,9 +40,15 @@ DateTime::DateTime(Controllers::Settings& settingsController) : settingsControll
 }
 
 void DateTime::SetCurrentTime(std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> t) {
+  auto sinceEpoch = t.time_since_epoch();
+  auto seconds = std::chrono::floor<std::chrono::seconds>(sinceEpoch);
+  int64_t localTicks = seconds.count() * configTICK_RATE_HZ + (sinceEpoch - seconds).count() * configTICK_RATE_HZ / 1000000000;
+
   xSemaphoreTake(mutex, portMAX_DELAY);
-  this->currentDateTime = t;
-  UpdateTime(previousSystickCounter, true); // Update internal state without updating the time
+  TimeBase timeBase = timeBases[timeBaseGeneration.load(std::memory_order_relaxed) & 1];
+  timeBase.offset = localTicks - static_cast<int64_t>(Ticks(timeBase));
+  StoreTimeBase(timeBase);
+  UpdateTime(nrf_rtc_counter_get(portNRF_RTC_REG), true);
   xSemaphoreGive(mutex);
 }
 
@@ -56,10 +67,7 @@ void DateTime::SetTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour,
 
   tm.tm_isdst = -1; // Use DST value from local time zone
 
-  xSemaphoreTake(mutex, portMAX_DELAY);
-  currentDateTime = std::chrono::system_clock::from_time_t(std::mktime(&tm));
-  UpdateTime(previousSystickCounter, true);
-  xSemaphoreGive(mutex);
+  SetCurrentTime(std::chrono::system_clock::from_time_t(std::mktime(&tm)));
 
   if (systemTask != nullptr) {
     systemTask->PushMessage(System::Messages::OnNewTime);
@@ -71,44 +79,108 @@ void DateTime::SetTimeZone(int8_t timezone, int8_t dst) {
   dstOffset = dst;
 }
 
-std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> DateTime::CurrentDateTime() {
+DateTime::TimeBase DateTime::LoadTimeBase() const {
+  TimeBase timeBase;
+  uint32_t generation;
+  do {
+    generation = timeBaseGeneration.load(std::memory_order_acquire);
+    timeBase = timeBases[generation & 1];
+    std::atomic_thread_fence(std::memory_order_acquire);
+  } while (generation != timeBaseGeneration.load(std::memory_order_relaxed));
+  return timeBase;
+}
+
+void DateTime::StoreTimeBase(const TimeBase& timeBase) {
+  uint32_t generation = timeBaseGeneration.load(std::memory_order_relaxed) + 1;
+  timeBases[generation & 1] = timeBase;
+  timeBaseGeneration.store(generation, std::memory_order_release);
+}
+
+uint64_t DateTime::Ticks(const TimeBase& timeBase) {
+  // The time base must be loaded before reading the counter, so that the counter is never behind it
+  return timeBase.ticks + ((nrf_rtc_counter_get(portNRF_RTC_REG) - timeBase.rtcCounter) & portNRF_RTC_MAXTICKS);
+}
+
+int64_t DateTime::LocalTicks(const TimeBase& timeBase) {
+  return static_cast<int64_t>(Ticks(timeBase)) + timeBase.offset;
+}
+
+std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> DateTime::CurrentDateTime() const {
+  int64_t localTicks = LocalTicks(LoadTimeBase());
+  return std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds>(
+    std::chrono::seconds(localTicks / configTICK_RATE_HZ) +
+    std::chrono::nanoseconds((localTicks % configTICK_RATE_HZ) * 1000000000 / configTICK_RATE_HZ));
+}
+
+std::chrono::seconds DateTime::Uptime() const {
+  return std::chrono::seconds(Ticks(LoadTimeBase()) / configTICK_RATE_HZ);
+}
+
+DateTime::Date DateTime::CurrentDate() const {
+  TimeBase timeBase = LoadTimeBase();
+  auto days = static_cast<int32_t>(LocalTicks(timeBase) / configTICK_RATE_HZ / secondsPerDay);
+  if (days == timeBase.date.days) {
+    return timeBase.date;
+  }
+  // The day changed since the last UpdateTime()
+  return DateFromDays(days);
+}
+
+uint32_t DateTime::SecondOfDay() const {
+  return static_cast<uint32_t>((LocalTicks(LoadTimeBase()) / configTICK_RATE_HZ) % secondsPerDay);
+}
+
+DateTime::Date DateTime::DateFromDays(int32_t days) {
+  // Days to civil date conversion from http://howardhinnant.github.io/date_algorithms.html
+  Date date;
+  date.days = days;
+  int32_t z = days + 719468;
+  int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+  auto dayOfEra = static_cast<uint32_t>(z - era * 146097);
+  uint32_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+  uint32_t dayOfMarchYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+  uint32_t marchMonth = (5 * dayOfMarchYear + 2) / 153;
+  date.day = dayOfMarchYear - (153 * marchMonth + 2) / 5 + 1;
+  date.month = marchMonth < 10 ? marchMonth + 3 : marchMonth - 9;
+  date.year = static_cast<int32_t>(yearOfEra) + era * 400 + (date.month <= 2 ? 1 : 0);
+
+  bool isLeapYear = (date.year % 4 == 0 && date.year % 100 != 0) || date.year % 400 == 0;
+  date.dayOfYear = DaysBeforeMonth[date.month - 1] + date.day - 1 + ((isLeapYear && date.month > 2) ? 1 : 0);
+  // 1970-01-01 was a Thursday
+  date.dayOfWeek = static_cast<uint8_t>(((days % 7) + 11) % 7);
+  return date;
+}
+
+void DateTime::UpdateTime() {
   xSemaphoreTake(mutex, portMAX_DELAY);
   UpdateTime(nrf_rtc_counter_get(portNRF_RTC_REG), false);
   xSemaphoreGive(mutex);
-  return currentDateTime;
 }
 
-void DateTime::UpdateTime(uint32_t systickCounter, bool forceUpdate) {
-  // Handle systick counter overflow
-  uint32_t systickDelta = 0;
-  if (systickCounter < previousSystickCounter) {
-    systickDelta = static_cast<uint32_t>(portNRF_RTC_MAXTICKS) - previousSystickCounter;
-    systickDelta += systickCounter + 1;
-  } else {
-    systickDelta = systickCounter - previousSystickCounter;
+void DateTime::UpdateTime(uint32_t rtcCounter, bool forceUpdate) {
+  // Extend the counter: the previous value is at most one overflow old
+  TimeBase timeBase = timeBases[timeBaseGeneration.load(std::memory_order_relaxed) & 1];
+  timeBase.ticks += (rtcCounter - timeBase.rtcCounter) & portNRF_RTC_MAXTICKS;
+  timeBase.rtcCounter = rtcCounter;
+
+  int64_t second = (static_cast<int64_t>(timeBase.ticks) + timeBase.offset) / configTICK_RATE_HZ;
+  auto days = static_cast<int32_t>(second / secondsPerDay);
+  if (days != timeBase.date.days || forceUpdate) {
+    timeBase.date = DateFromDays(days);
   }
+  StoreTimeBase(timeBase);
 
-  auto correctedDelta = systickDelta / configTICK_RATE_HZ;
   // If a second hasn't passed, there is nothing to do
   // If the time has been changed, set forceUpdate to trigger internal state updates
-  if (correctedDelta == 0 && !forceUpdate) {
+  if (second == previousSecond && !forceUpdate) {
     return;
   }
-  auto rest = systickDelta % configTICK_RATE_HZ;
-  if (systickCounter >= rest) {
-    previousSystickCounter = systickCounter - rest;
-  } else {
-    previousSystickCounter = static_cast<uint32_t>(portNRF_RTC_MAXTICKS) - (rest - systickCounter - 1);
-  }
+  previousSecond = second;
+  Utility::ChangeBus::Publish(Utility::Topic::Time);
 
-  currentDateTime += std::chrono::seconds(correctedDelta);
-  uptime += std::chrono::seconds(correctedDelta);
-
-  std::time_t currentTime = std::chrono::system_clock::to_time_t(currentDateTime);
-  localTime = *std::localtime(&currentTime);
-
-  auto minute = Minutes();
-  auto hour = Hours();
+  auto secondOfDay = static_cast<uint32_t>(second % secondsPerDay);
+  auto minute = (secondOfDay / 60) % 60;
+  auto hour = secondOfDay / 3600;
 
   if (minute == 0 && !isHourAlreadyNotified) {
     isHourAlreadyNotified = true;
@@ -168,7 +240,7 @@ void DateTime::Register(Pinetime::System::SystemTask* systemTask) {
 
 using ClockType = Pinetime::Controllers::Settings::ClockType;
 
-std::string DateTime::FormattedTime() {
+std::string DateTime::FormattedTime() const {
   auto hour = Hours();
   auto minute = Minutes();
   // Return time as a string in 12- or 24-hour format
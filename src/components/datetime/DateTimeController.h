@@ -1,8 +1,8 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <chrono>
-#include <ctime>
 #include <string>
 #include "components/settings/Settings.h"
 #include <FreeRTOS.h>
@@ -48,19 +48,19 @@ namespace Pinetime {
       void SetTimeZone(int8_t timezone, int8_t dst);
 
       uint16_t Year() const {
-        return 1900 + localTime.tm_year;
+        return CurrentDate().year;
       }
 
       Months Month() const {
-        return static_cast<Months>(localTime.tm_mon + 1);
+        return static_cast<Months>(CurrentDate().month);
       }
 
       uint8_t Day() const {
-        return localTime.tm_mday;
+        return CurrentDate().day;
       }
 
       Days DayOfWeek() const {
-        int daysSinceSunday = localTime.tm_wday;
+        uint8_t daysSinceSunday = CurrentDate().dayOfWeek;
         if (daysSinceSunday == 0) {
           return Days::Sunday;
         }
@@ -68,19 +68,19 @@ namespace Pinetime {
       }
 
       int DayOfYear() const {
-        return localTime.tm_yday + 1;
+        return CurrentDate().dayOfYear + 1;
       }
 
       uint8_t Hours() const {
-        return localTime.tm_hour;
+        return SecondOfDay() / 3600;
       }
 
       uint8_t Minutes() const {
-        return localTime.tm_min;
+        return (SecondOfDay() / 60) % 60;
       }
 
       uint8_t Seconds() const {
-        return localTime.tm_sec;
+        return SecondOfDay() % 60;
       }
 
       /*
@@ -126,32 +126,71 @@ namespace Pinetime {
       static const char* DayOfWeekShortToStringLow(Days day);
       static const char* DayOfWeekToStringLow(Days day);
 
-      std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> CurrentDateTime();
+      /*
+       * returns the local time, with the resolution of the RTC (1/1024s)
+       *
+       * Lock-free: it can be called from any task and doesn't change the state of the controller.
+       */
+      std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> CurrentDateTime() const;
 
-      std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> UTCDateTime() {
+      std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> UTCDateTime() const {
         return CurrentDateTime() - std::chrono::seconds((tzOffset + dstOffset) * 15 * 60);
       }
 
-      std::chrono::seconds Uptime() const {
-        return uptime;
-      }
+      std::chrono::seconds Uptime() const;
+
+      /*
+       * Follows the RTC counter and sends the new second/half hour/hour/day events.
+       *
+       * Must be called periodically, at least once per RTC counter overflow (16384s). SystemTask calls it every 100ms.
+       */
+      void UpdateTime();
 
       void Register(System::SystemTask* systemTask);
       void SetCurrentTime(std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> t);
-      std::string FormattedTime();
+      std::string FormattedTime() const;
 
     private:
-      void UpdateTime(uint32_t systickCounter, bool forceUpdate);
+      // Calendar date, only recomputed when the day changes
+      struct Date {
+        int32_t days = 0; // Since 1970-01-01
+        uint16_t year = 1970;
+        uint8_t month = 1;
+        uint8_t day = 1;
+        uint8_t dayOfWeek = 4; // Since Sunday
+        uint16_t dayOfYear = 0;
+      };
+
+      // Time is counted in RTC ticks (1/configTICK_RATE_HZ s). The 24 bits RTC counter is extended by UpdateTime() into
+      // a monotonic tick count since boot, and the local time is that count plus an offset set by SetCurrentTime().
+      struct TimeBase {
+        uint32_t rtcCounter = 0;
+        uint64_t ticks = 0;  // Monotonic ticks at rtcCounter
+        int64_t offset = 0;  // Local time (ticks since epoch) - monotonic ticks
+        Date date;
+      };
+
+      static Date DateFromDays(int32_t days);
+
+      // Double-buffered snapshot: readers copy the buffer selected by the generation and retry if it changed meanwhile.
+      // Writers are serialized by the mutex and only write the other buffer, so a preempted writer never blocks readers.
+      TimeBase LoadTimeBase() const;
+      void StoreTimeBase(const TimeBase& timeBase);
+      static uint64_t Ticks(const TimeBase& timeBase);
+      static int64_t LocalTicks(const TimeBase& timeBase);
+      Date CurrentDate() const;
+      uint32_t SecondOfDay() const;
+
+      void UpdateTime(uint32_t rtcCounter, bool forceUpdate);
 
-      std::tm localTime;
       int8_t tzOffset = 0;
       int8_t dstOffset = 0;
 
       SemaphoreHandle_t mutex = nullptr;
 
-      uint32_t previousSystickCounter = 0;
-      std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> currentDateTime;
-      std::chrono::seconds uptime {0};
+      TimeBase timeBases[2];
+      std::atomic<uint32_t> timeBaseGeneration {0};
+      int64_t previousSecond = 0;
 
       bool isMidnightAlreadyNotified = false;
       bool isHourAlreadyNotified = true;
@@ -7,12 +7,15 @@ using namespace Pinetime::Controllers;
 
 FS::FS(Pinetime::Drivers::SpiNorFlash& driver)
   : flashDriver {driver},
+    readCache {driver, startAddress, size},
     lfsConfig {
       .context = this,
       .read = SectorRead,
       .prog = SectorProg,
       .erase = SectorErase,
       .sync = SectorSync,
+      .lock = Lock,
+      .unlock = Unlock,
 
       .read_size = 16,
       .prog_size = 8,
@@ -26,9 +29,11 @@ FS::FS(Pinetime::Drivers::SpiNorFlash& driver)
       .name_max = 50,
       .attr_max = 50,
     } {
+  lfsMutex = xSemaphoreCreateMutex();
 }
 
 void FS::Init() {
+  readCache.Init();
 
   // try mount
   int err = lfs_mount(&lfs, &lfsConfig);
@@ -58,7 +63,12 @@ int FS::FileOpen(lfs_file_t* file_p, const char* fileName, const int flags) {
 }
 
 int FS::FileClose(lfs_file_t* file_p) {
-  return lfs_file_close(&lfs, file_p);
+  const bool written = (file_p->flags & LFS_O_WRONLY) != 0;
+  int res = lfs_file_close(&lfs, file_p);
+  if (written) {
+    modificationCount++;
+  }
+  return res;
 }
 
 int FS::FileRead(lfs_file_t* file_p, uint8_t* buff, uint32_t size) {
@@ -66,6 +76,7 @@ int FS::FileRead(lfs_file_t* file_p, uint8_t* buff, uint32_t size) {
 }
 
 int FS::FileWrite(lfs_file_t* file_p, const uint8_t* buff, uint32_t size) {
+  modificationCount++;
   return lfs_file_write(&lfs, file_p, buff, size);
 }
 
@@ -74,6 +85,7 @@ int FS::FileSeek(lfs_file_t* file_p, uint32_t pos) {
 }
 
 int FS::FileDelete(const char* fileName) {
+  modificationCount++;
   return lfs_remove(&lfs, fileName);
 }
 
@@ -98,6 +110,7 @@ int FS::DirCreate(const char* path) {
 }
 
 int FS::Rename(const char* oldPath, const char* newPath) {
+  modificationCount++;
   return lfs_rename(&lfs, oldPath, newPath);
 }
 
@@ -121,6 +134,7 @@ int FS::SectorSync(const struct lfs_config* /*c*/) {
 int FS::SectorErase(const struct lfs_config* c, lfs_block_t block) {
   Pinetime::Controllers::FS& lfs = *(static_cast<Pinetime::Controllers::FS*>(c->context));
   const size_t address = startAddress + (block * blockSize);
+  lfs.readCache.Invalidate(address, blockSize);
   lfs.flashDriver.SectorErase(address);
   return lfs.flashDriver.EraseFailed() ? -1 : 0;
 }
@@ -128,6 +142,7 @@ int FS::SectorErase(const struct lfs_config* c, lfs_block_t block) {
 int FS::SectorProg(const struct lfs_config* c, lfs_block_t block, lfs_off_t off, const void* buffer, lfs_size_t size) {
   Pinetime::Controllers::FS& lfs = *(static_cast<Pinetime::Controllers::FS*>(c->context));
   const size_t address = startAddress + (block * blockSize) + off;
+  lfs.readCache.Invalidate(address, size);
   lfs.flashDriver.Write(address, (uint8_t*) buffer, size);
   return lfs.flashDriver.ProgramFailed() ? -1 : 0;
 }
@@ -135,6 +150,18 @@ int FS::SectorProg(const struct lfs_config* c, lfs_block_t block, lfs_off_t off,
 int FS::SectorRead(const struct lfs_config* c, lfs_block_t block, lfs_off_t off, void* buffer, lfs_size_t size) {
   Pinetime::Controllers::FS& lfs = *(static_cast<Pinetime::Controllers::FS*>(c->context));
   const size_t address = startAddress + (block * blockSize) + off;
-  lfs.flashDriver.Read(address, static_cast<uint8_t*>(buffer), size);
+  lfs.readCache.Read(address, static_cast<uint8_t*>(buffer), size);
+  return 0;
+}
+
+int FS::Lock(const struct lfs_config* c) {
+  Pinetime::Controllers::FS& lfs = *(static_cast<Pinetime::Controllers::FS*>(c->context));
+  xSemaphoreTake(lfs.lfsMutex, portMAX_DELAY);
+  return 0;
+}
+
+int FS::Unlock(const struct lfs_config* c) {
+  Pinetime::Controllers::FS& lfs = *(static_cast<Pinetime::Controllers::FS*>(c->context));
+  xSemaphoreGive(lfs.lfsMutex);
   return 0;
 }
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
+#include <FreeRTOS.h>
+#include <semphr.h>
 #include "drivers/SpiNorFlash.h"
+#include "components/fs/FlashReadCache.h"
 #include <littlefs/lfs.h>
 
 namespace Pinetime {
@@ -31,6 +35,12 @@ namespace Pinetime {
       int Stat(const char* path, lfs_info* info);
       void VerifyResource();
 
+      // Incremented each time a file is written, closed after writing, deleted or renamed. Files kept open for a
+      // long time (fonts) compare it to reload their content when it may have changed.
+      uint32_t ModificationCount() const {
+        return modificationCount;
+      }
+
       static size_t getSize() {
         return size;
       }
@@ -69,14 +79,20 @@ namespace Pinetime {
       static constexpr size_t blockSize = 4096;
 
       bool resourcesValid = false;
+      FlashReadCache readCache;
       const struct lfs_config lfsConfig;
 
       lfs_t lfs;
+      // The filesystem is used from the display, system and BLE host tasks. littlefs takes it for each call.
+      SemaphoreHandle_t lfsMutex;
+      std::atomic<uint32_t> modificationCount {0};
 
       static int SectorSync(const struct lfs_config* c);
       static int SectorErase(const struct lfs_config* c, lfs_block_t block);
       static int SectorProg(const struct lfs_config* c, lfs_block_t block, lfs_off_t off, const void* buffer, lfs_size_t size);
       static int SectorRead(const struct lfs_config* c, lfs_block_t block, lfs_off_t off, void* buffer, lfs_size_t size);
+      static int Lock(const struct lfs_config* c);
+      static int Unlock(const struct lfs_config* c);
     };
   }
 }
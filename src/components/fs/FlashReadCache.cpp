@@ -0,0 +1,131 @@
+#include "components/fs/FlashReadCache.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace Pinetime::Controllers;
+
+FlashReadCache::FlashReadCache(Pinetime::Drivers::SpiNorFlash& flashDriver, uint32_t startAddress, size_t size)
+  : flashDriver {flashDriver}, endAddress {startAddress + size} {
+}
+
+void FlashReadCache::Init() {
+  if (prefetchDone == nullptr) {
+    prefetchDone = xSemaphoreCreateBinary();
+  }
+}
+
+void FlashReadCache::Read(uint32_t address, uint8_t* buffer, size_t size) {
+  while (size > 0) {
+    const uint32_t pageAddress = address & ~(pageSize - 1);
+    const size_t offset = address - pageAddress;
+
+    if (offset == 0 && size >= pageSize) {
+      // Copying whole pages through the cache would not save any flash access
+      const size_t directSize = size & ~(pageSize - 1);
+      flashDriver.Read(address, buffer, directSize);
+      address += directSize;
+      buffer += directSize;
+      size -= directSize;
+      continue;
+    }
+
+    const size_t chunkSize = std::min(size, pageSize - offset);
+    Page& page = GetPage(pageAddress);
+    std::memcpy(buffer, page.data.data() + offset, chunkSize);
+    address += chunkSize;
+    buffer += chunkSize;
+    size -= chunkSize;
+  }
+}
+
+void FlashReadCache::Invalidate(uint32_t address, size_t size) {
+  for (auto& page : pages) {
+    if (page.address < address + size && address < page.address + pageSize) {
+      WaitLoaded(page);
+      page.valid = false;
+    }
+  }
+}
+
+FlashReadCache::Page& FlashReadCache::GetPage(uint32_t pageAddress) {
+  Page* page = FindPage(pageAddress);
+  if (page != nullptr) {
+    WaitLoaded(*page);
+  } else {
+    page = &EvictPage();
+    flashDriver.Read(pageAddress, page->data.data(), pageSize);
+    page->address = pageAddress;
+    page->valid = true;
+  }
+  page->lastUse = ++useCounter;
+
+  // Sequential access: read the next page in the background while the caller processes this one
+  if (pageAddress != lastPageAddress) {
+    if (pageAddress == lastPageAddress + pageSize) {
+      Prefetch(pageAddress + pageSize);
+    }
+    lastPageAddress = pageAddress;
+  }
+  return *page;
+}
+
+FlashReadCache::Page* FlashReadCache::FindPage(uint32_t pageAddress) {
+  for (auto& page : pages) {
+    if (page.valid && page.address == pageAddress) {
+      return &page;
+    }
+  }
+  return nullptr;
+}
+
+FlashReadCache::Page& FlashReadCache::EvictPage() {
+  Page* victim = nullptr;
+  for (auto& page : pages) {
+    if (page.loading) {
+      continue;
+    }
+    if (!page.valid) {
+      return page;
+    }
+    if (victim == nullptr || page.lastUse < victim->lastUse) {
+      victim = &page;
+    }
+  }
+  // Only one prefetch is in flight at a time, so there is always a page that is not loading
+  victim->valid = false;
+  return *victim;
+}
+
+void FlashReadCache::Prefetch(uint32_t pageAddress) {
+  if (prefetchDone == nullptr || pageAddress + pageSize > endAddress || FindPage(pageAddress) != nullptr) {
+    return;
+  }
+  for (auto& page : pages) {
+    if (page.loading) {
+      return;
+    }
+  }
+
+  Page& page = EvictPage();
+  page.address = pageAddress;
+  page.valid = true;
+  page.loading = true;
+  // Keep the page that is being read out of the LRU tail until it is used
+  page.lastUse = useCounter;
+  auto onLoaded = [this, &page]() {
+    page.loading = false;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    xSemaphoreGiveFromISR(prefetchDone, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+  };
+  if (!flashDriver.ReadAsync(pageAddress, page.data.data(), pageSize, onLoaded)) {
+    page.loading = false;
+    page.valid = false;
+  }
+}
+
+void FlashReadCache::WaitLoaded(Page& page) {
+  while (page.loading) {
+    xSemaphoreTake(prefetchDone, 1);
+  }
+}
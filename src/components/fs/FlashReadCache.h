@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <FreeRTOS.h>
+#include <semphr.h>
+#include "drivers/SpiNorFlash.h"
+
+namespace Pinetime {
+  namespace Controllers {
+    // Read cache between littlefs and the SPI NOR flash.
+    // littlefs reads the flash in very small chunks (read_size), this cache groups them into reads of whole 256 bytes pages
+    // kept in a small LRU. When the pages are read sequentially, the next page is prefetched in the background.
+    // Large page-aligned reads bypass the cache.
+    class FlashReadCache {
+    public:
+      FlashReadCache(Pinetime::Drivers::SpiNorFlash& flashDriver, uint32_t startAddress, size_t size);
+
+      void Init();
+
+      void Read(uint32_t address, uint8_t* buffer, size_t size);
+      // Must be called before the given range of the flash is programmed or erased
+      void Invalidate(uint32_t address, size_t size);
+
+    private:
+      static constexpr size_t pageSize = 256;
+      static constexpr size_t nbPages = 4;
+
+      struct Page {
+        uint32_t address = 0;
+        uint32_t lastUse = 0;
+        bool valid = false;
+        volatile bool loading = false;
+        std::array<uint8_t, pageSize> data;
+      };
+
+      Page& GetPage(uint32_t pageAddress);
+      Page* FindPage(uint32_t pageAddress);
+      Page& EvictPage();
+      void Prefetch(uint32_t pageAddress);
+      void WaitLoaded(Page& page);
+
+      Pinetime::Drivers::SpiNorFlash& flashDriver;
+      const uint32_t endAddress;
+
+      std::array<Page, nbPages> pages;
+      uint32_t useCounter = 0;
+      uint32_t lastPageAddress = 0;
+      SemaphoreHandle_t prefetchDone = nullptr;
+    };
+  }
+}
@@ -1,20 +1,26 @@
 #include "components/heartrate/HeartRateController.h"
 #include <heartratetask/HeartRateTask.h>
 #include <systemtask/SystemTask.h>
+#include "utility/ChangeBus.h"
 
 using namespace Pinetime::Controllers;
 
 void HeartRateController::Update(HeartRateController::States newState, uint8_t heartRate) {
-  this->state = newState;
+  if (this->state != newState) {
+    this->state = newState;
+    Utility::ChangeBus::Publish(Utility::Topic::HeartRate);
+  }
   if (this->heartRate != heartRate) {
     this->heartRate = heartRate;
     service->OnNewHeartRateValue(heartRate);
+    Utility::ChangeBus::Publish(Utility::Topic::HeartRate);
   }
 }
 
 void HeartRateController::Start() {
   if (task != nullptr) {
     state = States::NotEnoughData;
+    Utility::ChangeBus::Publish(Utility::Topic::HeartRate);
     task->PushMessage(Pinetime::Applications::HeartRateTask::Messages::StartMeasurement);
   }
 }
@@ -22,6 +28,7 @@ void HeartRateController::Start() {
 void HeartRateController::Stop() {
   if (task != nullptr) {
     state = States::Stopped;
+    Utility::ChangeBus::Publish(Utility::Topic::HeartRate);
     task->PushMessage(Pinetime::Applications::HeartRateTask::Messages::StopMeasurement);
   }
 }
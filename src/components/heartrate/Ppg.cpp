@@ -1,40 +1,228 @@
 #include "components/heartrate/Ppg.h"
-#include <nrf_log.h>
-#include <vector>
+#include <algorithm>
+#include <cmath>
 
 using namespace Pinetime::Controllers;
 
 namespace {
-  float LinearInterpolation(const float* xValues, const float* yValues, int length, float pointX) {
-    if (pointX > xValues[length - 1]) {
-      return yValues[length - 1];
-    } else if (pointX <= xValues[0]) {
-      return yValues[0];
+  // cos(2 * pi * k / dataLength), from a table holding its first quarter period
+  template <typename T, size_t N>
+  T QuarterWaveCosine(const T (&table)[N], int k) {
+    static_assert(N == (Ppg::dataLength >> 2) + 1);
+    constexpr int quarter = Ppg::dataLength >> 2;
+    k &= Ppg::dataLength - 1;
+    if (k <= quarter) {
+      return table[k];
+    } else if (k <= 2 * quarter) {
+      return -table[2 * quarter - k];
+    } else if (k <= 3 * quarter) {
+      return -table[k - 2 * quarter];
+    }
+    return table[4 * quarter - k];
+  }
+
+#ifdef HEARTRATE_FIXED_POINT
+  // Samples are processed in Q8. An int32 leaves 23 bits per sample, the 64 point transform
+  // accumulates at most 6 more bits: enough for the 16 bit ADC values.
+  constexpr int fractionalBits = 8;
+  constexpr int32_t one = 1 << fractionalBits;
+
+  // EMA coefficients of Filter30to240 (0.816 and 0.268) in Q15
+  constexpr int32_t lowPassAlpha = 26739;
+  constexpr int32_t highPassAlpha = 8782;
+
+  // First half of the Hanning window from numpy: python -c 'import numpy;print(numpy.hanning(64))', in Q15
+  constexpr int16_t hanningQ15[Ppg::dataLength >> 1] {
+    0,     81,    325,   728,   1287,  1995,  2847,  3833,  4944,  6169,  7495,  8909,  10398, 11947, 13539, 15160,
+    16792, 18421, 20030, 21602, 23123, 24576, 25948, 27225, 28394, 29444, 30364, 31145, 31780, 32261, 32585, 32748};
+
+  // cos(2 * pi * k / dataLength) in Q15 for the first quarter period
+  constexpr int16_t cosineQ15[(Ppg::dataLength >> 2) + 1] {
+    32767, 32609, 32137, 31356, 30273, 28898, 27245, 25329, 23170, 20787, 18204, 15446, 12539, 9512, 6393, 3212, 0};
+
+  int32_t Cosine(int k) {
+    return QuarterWaveCosine(cosineQ15, k);
+  }
+
+  int32_t Sine(int k) {
+    return Cosine(k - (Ppg::dataLength >> 2));
+  }
+
+  int32_t MulQ15(int32_t value, int32_t coefficient) {
+    return static_cast<int32_t>((static_cast<int64_t>(value) * coefficient) >> 15);
+  }
+
+  uint32_t SquareRoot(uint64_t value) {
+    uint64_t result = 0;
+    uint64_t bit = 1ULL << 62;
+    while (bit > value) {
+      bit >>= 2;
+    }
+    while (bit != 0) {
+      if (value >= result + bit) {
+        value -= result + bit;
+        result = (result >> 1) + bit;
+      } else {
+        result >>= 1;
+      }
+      bit >>= 2;
+    }
+    return static_cast<uint32_t>(result);
+  }
+
+  // Detrend, Filter30to240 and the Hanning window of the floating point implementation, in a single pass.
+  // Each pass of Filter30to240 starts from the first value of its input, which is known in advance:
+  // the low-pass passes and the first high-pass pass start at the first sample, the others at 0.
+  // All the passes can therefore run as a cascade of filters on each sample.
+  // data is a ring buffer holding its oldest sample at index start.
+  void DetrendFilterWindow(const std::array<uint16_t, Ppg::dataLength>& data, int start, std::array<int32_t, Ppg::dataLength>& frame) {
+    constexpr int length = Ppg::dataLength;
+    auto sample = [&](int idx) -> int32_t {
+      return data[(start + idx) & (length - 1)];
+    };
+    const int32_t slope = ((sample(length - 1) - sample(0)) * one) / (length - 1);
+    auto difference = [&](int idx) -> int32_t {
+      // Derivative of the detrended signal, its last sample is always 0
+      if (idx == length - 1) {
+        return 0;
+      }
+      return (sample(idx + 1) - sample(idx)) * one - slope;
+    };
+
+    const int32_t first = difference(0);
+    int32_t lowPass[4] = {first, first, first, first};
+    int32_t highPass[4] = {first, 0, 0, 0};
+    for (int idx = 0; idx < length; idx++) {
+      int32_t value = difference(idx);
+      for (auto& state : lowPass) {
+        state += MulQ15(value - state, lowPassAlpha);
+        value = state;
+      }
+      for (auto& state : highPass) {
+        state += MulQ15(value - state, highPassAlpha);
+        value -= state;
+      }
+      int hannIdx = idx < (length >> 1) ? idx : length - 1 - idx;
+      frame[idx] = MulQ15(value, hanningQ15[hannIdx]);
+    }
+  }
+
+  // In place radix-2 FFT of size complex values stored as interleaved real and imaginary parts
+  void ComplexFft(int32_t* data, int size) {
+    for (int idx = 1, reversed = 0; idx < size; idx++) {
+      int bit = size >> 1;
+      for (; reversed & bit; bit >>= 1) {
+        reversed ^= bit;
+      }
+      reversed ^= bit;
+      if (idx < reversed) {
+        std::swap(data[2 * idx], data[2 * reversed]);
+        std::swap(data[2 * idx + 1], data[2 * reversed + 1]);
+      }
+    }
+
+    for (int span = 2; span <= size; span <<= 1) {
+      const int half = span >> 1;
+      // Twiddle factors are indexed in steps of 2 * pi / dataLength
+      const int step = Ppg::dataLength / span;
+      for (int start = 0; start < size; start += span) {
+        for (int idx = 0; idx < half; idx++) {
+          const int32_t cosine = Cosine(idx * step);
+          const int32_t sine = Sine(idx * step);
+          int32_t* a = &data[2 * (start + idx)];
+          int32_t* b = &data[2 * (start + idx + half)];
+          const int32_t re = MulQ15(b[0], cosine) + MulQ15(b[1], sine);
+          const int32_t im = MulQ15(b[1], cosine) - MulQ15(b[0], sine);
+          b[0] = a[0] - re;
+          b[1] = a[1] - im;
+          a[0] += re;
+          a[1] += im;
+        }
+      }
+    }
+  }
+
+  // Location of the single peak above threshold (Q8 bins), 0 if there are none or several.
+  // The edges of the peak are interpolated linearly between bins and its center is refined with
+  // a parabola fitted on the highest bin and its neighbours.
+  int32_t PeakSearch(const std::array<int32_t, Ppg::spectrumLength>& data, int32_t threshold, int32_t& width, int start, int end) {
+    int peaks = 0;
+    bool inPeak = false;
+    int32_t minBin = 0;
+    int peakBin = 0;
+    int32_t peakCenter = 0;
+    for (int idx = start; idx < end; idx++) {
+      const int64_t current = data[idx];
+      const int64_t next = data[idx + 1];
+      if (current < threshold && next >= threshold) {
+        inPeak = true;
+        minBin = idx * one + static_cast<int32_t>(((threshold - current) * one) / (next - current));
+        peakBin = idx + 1;
+      } else if (inPeak && current >= threshold && next < threshold) {
+        inPeak = false;
+        int32_t maxBin = idx * one + static_cast<int32_t>(((current - threshold) * one) / (current - next));
+        peaks++;
+        width = maxBin - minBin;
+
+        const int64_t left = data[peakBin - 1];
+        const int64_t center = data[peakBin];
+        const int64_t right = data[peakBin + 1];
+        const int64_t curvature = left - 2 * center + right;
+        peakCenter = peakBin * one;
+        if (curvature < 0) {
+          peakCenter += static_cast<int32_t>(((left - right) * (one / 2)) / curvature);
+        }
+      } else if (inPeak && next > data[peakBin]) {
+        peakBin = idx + 1;
+      }
     }
-    int index = 0;
-    while (pointX > xValues[index] && index < length - 1) {
-      index++;
+    if (peaks != 1) {
+      width = 0;
+      peakCenter = 0;
     }
-    float pointX0 = xValues[index - 1];
-    float pointX1 = xValues[index];
-    float pointY0 = yValues[index - 1];
-    float pointY1 = yValues[index];
-    float mu = (pointX - pointX0) / (pointX1 - pointX0);
+    return peakCenter;
+  }
+#else
+  // EMA coefficients of the band-pass filter: 0.268 is ~0.5Hz and 0.816 is ~4Hz cutoff at 10Hz sampling
+  constexpr float lowPassAlpha = 0.816f;
+  constexpr float highPassAlpha = 0.268f;
+
+  // cos(2 * pi * k / dataLength) for the first quarter period
+  constexpr float cosine[(Ppg::dataLength >> 2) + 1] {
+    1.0f,        0.99518473f, 0.98078528f, 0.95694034f, 0.92387953f, 0.88192126f, 0.83146961f, 0.77301045f, 0.70710678f,
+    0.63439328f, 0.55557023f, 0.47139674f, 0.38268343f, 0.29028468f, 0.19509032f, 0.09801714f, 0.0f};
+
+  float Cosine(int k) {
+    return QuarterWaveCosine(cosine, k);
+  }
+
+  float Sine(int k) {
+    return Cosine(k - (Ppg::dataLength >> 2));
+  }
 
-    return (pointY0 * (1 - mu) + pointY1 * mu);
+  // Interpolates linearly between the bins surrounding pointX
+  float LinearInterpolation(const float* yValues, int length, float pointX) {
+    if (pointX >= static_cast<float>(length - 1)) {
+      return yValues[length - 1];
+    } else if (pointX <= 0.0f) {
+      return yValues[0];
+    }
+    auto index = static_cast<int>(pointX);
+    float mu = pointX - static_cast<float>(index);
+    return (yValues[index] * (1 - mu) + yValues[index + 1] * mu);
   }
 
-  float PeakSearch(float* xVals, float* yVals, float threshold, float& width, float start, float end, int length) {
+  float PeakSearch(const float* yVals, float threshold, float& width, float start, float end, int length) {
     int peaks = 0;
     bool enabled = false;
     float minBin = 0.0f;
     float maxBin = 0.0f;
     float peakCenter = 0.0f;
-    float prevValue = LinearInterpolation(xVals, yVals, length, start - 0.01f);
-    float currValue = LinearInterpolation(xVals, yVals, length, start);
+    float prevValue = LinearInterpolation(yVals, length, start - 0.01f);
+    float currValue = LinearInterpolation(yVals, length, start);
     float idx = start;
     while (idx < end) {
-      float nextValue = LinearInterpolation(xVals, yVals, length, idx + 0.01f);
+      float nextValue = LinearInterpolation(yVals, length, idx + 0.01f);
       if (currValue < threshold) {
         enabled = true;
       }
@@ -77,32 +265,6 @@ namespace {
     return max / mean;
   }
 
-  // Simple bandpass filter using exponential moving average
-  void Filter30to240(std::array<float, Ppg::dataLength>& signal) {
-    // From:
-    // https://www.norwegiancreations.com/2016/03/arduino-tutorial-simple-high-pass-band-pass-and-band-stop-filtering/
-
-    int length = signal.size();
-    // 0.268 is ~0.5Hz and 0.816 is ~4Hz cutoff at 10Hz sampling
-    float expAlpha = 0.816f;
-    float expAvg = 0.0f;
-    for (int loop = 0; loop < 4; loop++) {
-      expAvg = signal.front();
-      for (int idx = 0; idx < length; idx++) {
-        expAvg = (expAlpha * signal.at(idx)) + ((1 - expAlpha) * expAvg);
-        signal[idx] = expAvg;
-      }
-    }
-    expAlpha = 0.268f;
-    for (int loop = 0; loop < 4; loop++) {
-      expAvg = signal.front();
-      for (int idx = 0; idx < length; idx++) {
-        expAvg = (expAlpha * signal.at(idx)) + ((1 - expAlpha) * expAvg);
-        signal[idx] -= expAvg;
-      }
-    }
-  }
-
   float SpectrumMax(const std::array<float, Ppg::spectrumLength>& data, int start, int end) {
     float max = 0.0f;
     for (int idx = start; idx < end; idx++) {
@@ -112,40 +274,24 @@ namespace {
     }
     return max;
   }
-
-  void Detrend(std::array<float, Ppg::dataLength>& signal) {
-    int size = signal.size();
-    float offset = signal.front();
-    float slope = (signal.at(size - 1) - offset) / static_cast<float>(size - 1);
-
-    for (int idx = 0; idx < size; idx++) {
-      signal[idx] -= (slope * static_cast<float>(idx) + offset);
-    }
-    for (int idx = 0; idx < size - 1; idx++) {
-      signal[idx] = signal[idx + 1] - signal[idx];
-    }
-  }
-
-  // Hanning Coefficients from numpy: python -c 'import numpy;print(numpy.hanning(64))'
-  // Note: Harcoded and must be updated if constexpr dataLength is changed. Prevents the need to
-  // use cosf() which results in an extra ~5KB in storage.
-  // This data is symetrical so just using the first half (saves 128B when dataLength is 64).
-  static constexpr float hanning[Ppg::dataLength >> 1] {
-    0.0f,        0.00248461f, 0.00991376f, 0.0222136f,  0.03926189f, 0.06088921f, 0.08688061f, 0.11697778f,
-    0.15088159f, 0.1882551f,  0.22872687f, 0.27189467f, 0.31732949f, 0.36457977f, 0.41317591f, 0.46263495f,
-    0.51246535f, 0.56217185f, 0.61126047f, 0.65924333f, 0.70564355f, 0.75f,       0.79187184f, 0.83084292f,
-    0.86652594f, 0.89856625f, 0.92664544f, 0.95048443f, 0.96984631f, 0.98453864f, 0.99441541f, 0.99937846f};
+#endif
 }
 
 Ppg::Ppg() {
   dataAverage.fill(0.0f);
-  spectrum.fill(0.0f);
+  spectrum.fill(0);
 }
 
 int8_t Ppg::Preprocess(uint16_t hrs, uint16_t als) {
+#ifndef HEARTRATE_FIXED_POINT
+  UpdateSpectrum(hrs);
+#endif
+  dataHRS[dataHead] = hrs;
+  dataHead = (dataHead + 1) & (dataLength - 1);
   if (dataIndex < dataLength) {
-    dataHRS[dataIndex++] = hrs;
+    dataIndex++;
   }
+  newSamples++;
   alsValue = als;
   if (alsValue > alsThreshold) {
     return 1;
@@ -154,23 +300,29 @@ int8_t Ppg::Preprocess(uint16_t hrs, uint16_t als) {
 }
 
 int Ppg::HeartRate() {
-  if (dataIndex < dataLength) {
+  // Wait for a full window, then analyze every overlapWindow new samples
+  if (dataIndex < dataLength || newSamples < overlapWindow) {
     return 0;
   }
-  int hr = 0;
-  hr = ProcessHeartRate(resetSpectralAvg);
+  newSamples = 0;
+  int hr = ProcessHeartRate(resetSpectralAvg);
   resetSpectralAvg = false;
-  // Make room for overlapWindow number of new samples
-  for (int idx = 0; idx < dataLength - overlapWindow; idx++) {
-    dataHRS[idx] = dataHRS[idx + overlapWindow];
-  }
-  dataIndex = dataLength - overlapWindow;
   return hr;
 }
 
 void Ppg::Reset(bool resetDaqBuffer) {
   if (resetDaqBuffer) {
     dataIndex = 0;
+    dataHead = 0;
+    newSamples = 0;
+#ifndef HEARTRATE_FIXED_POINT
+    filtered.fill(0.0f);
+    dftReal.fill(0.0f);
+    dftImag.fill(0.0f);
+    lowPassState.fill(0.0f);
+    highPassState.fill(0.0f);
+    samplesSinceResync = 0;
+#endif
   }
   avgIndex = 0;
   dataAverage.fill(0.0f);
@@ -178,54 +330,149 @@ void Ppg::Reset(bool resetDaqBuffer) {
   alsThreshold = UINT16_MAX;
   alsValue = 0;
   resetSpectralAvg = true;
-  spectrum.fill(0.0f);
+  spectrum.fill(0);
 }
 
-// Pass init == true to reset spectral averaging.
-// Returns -1 (Reset Acquisition), 0 (Unable to obtain HR) or HR (BPM).
-int Ppg::ProcessHeartRate(bool init) {
-  std::copy(dataHRS.begin(), dataHRS.end(), vReal.begin());
-  Detrend(vReal);
-  Filter30to240(vReal);
-  vImag.fill(0.0f);
-  // Apply Hanning Window
-  int hannIdx = 0;
-  for (int idx = 0; idx < dataLength; idx++) {
-    if (idx >= dataLength >> 1) {
-      hannIdx--;
+#ifdef HEARTRATE_FIXED_POINT
+float Ppg::SpectrumPeak(bool init, float& peakWidth) {
+  DetrendFilterWindow(dataHRS, dataHead, frame);
+  // Real input FFT: the samples are transformed as dataLength / 2 complex values (even samples as real
+  // parts, odd samples as imaginary parts) and the result is split into the spectrum of the real signal.
+  constexpr int halfLength = dataLength >> 1;
+  ComplexFft(frame.data(), halfLength);
+
+  if (init) {
+    spectralAvgCount = 0;
+  }
+  const int64_t count = spectralAvgCount;
+  auto average = [this, count](int bin, int64_t re, int64_t im) {
+    int64_t magnitude = SquareRoot(static_cast<uint64_t>(re * re + im * im));
+    spectrum[bin] = static_cast<int32_t>((spectrum[bin] * count + magnitude) / (count + 1));
+  };
+  average(0, static_cast<int64_t>(frame[0]) + frame[1], 0);
+  for (int bin = 1; bin <= halfLength / 2; bin++) {
+    const int32_t* z = &frame[2 * bin];
+    const int32_t* mirror = &frame[2 * (halfLength - bin)];
+    // Transforms of the even (e) and odd (o) samples
+    const int64_t eRe = (static_cast<int64_t>(z[0]) + mirror[0]) / 2;
+    const int64_t eIm = (static_cast<int64_t>(z[1]) - mirror[1]) / 2;
+    const int64_t oRe = (static_cast<int64_t>(z[1]) + mirror[1]) / 2;
+    const int64_t oIm = (static_cast<int64_t>(mirror[0]) - z[0]) / 2;
+    const int64_t cosine = Cosine(bin);
+    const int64_t sine = Sine(bin);
+    const int64_t tRe = (oRe * cosine + oIm * sine) >> 15;
+    const int64_t tIm = (oIm * cosine - oRe * sine) >> 15;
+    average(bin, eRe + tRe, eIm + tIm);
+    if (bin != halfLength - bin) {
+      average(halfLength - bin, eRe - tRe, eIm - tIm);
     }
-    vReal[idx] *= hanning[hannIdx];
-    if (idx < dataLength >> 1) {
-      hannIdx++;
+  }
+  if (spectralAvgCount < spectralAvgMax) {
+    spectralAvgCount++;
+  }
+
+  int32_t max = 0;
+  int64_t sum = 0;
+  for (int idx = hrROIbegin; idx < hrROIend; idx++) {
+    max = std::max(max, spectrum[idx]);
+    sum += spectrum[idx];
+  }
+  const float mean = static_cast<float>(sum) / static_cast<float>(hrROIend - hrROIbegin);
+  if (static_cast<float>(max) <= signalToNoiseThreshold * mean || static_cast<float>(spectrum[0]) >= dcThreshold * one) {
+    return 0.0f;
+  }
+
+  int32_t width = 0;
+  auto threshold = static_cast<int32_t>(peakDetectionThreshold * static_cast<float>(max));
+  int32_t location = PeakSearch(spectrum, threshold, width, hrROIbegin, hrROIend);
+  peakWidth = static_cast<float>(width) / one;
+  return static_cast<float>(location) / one * freqResolution;
+}
+#else
+void Ppg::UpdateSpectrum(uint16_t hrs) {
+  // The band-pass filter runs on the derivative of the signal, its states are kept from one sample to the next
+  float value = dataIndex > 0 ? static_cast<float>(hrs) - static_cast<float>(lastHrs) : 0.0f;
+  lastHrs = hrs;
+  for (auto& state : lowPassState) {
+    state += lowPassAlpha * (value - state);
+    value = state;
+  }
+  for (auto& state : highPassState) {
+    state += highPassAlpha * (value - state);
+    value -= state;
+  }
+
+  // Sliding DFT: X[k] = (X[k] - oldest + newest) * e^(2 * pi * k / dataLength)
+  const float delta = value - filtered[dataHead];
+  filtered[dataHead] = value;
+  for (int bin = 0; bin < dftBins; bin++) {
+    const float re = dftReal[bin] + delta;
+    const float im = dftImag[bin];
+    dftReal[bin] = re * Cosine(bin) - im * Sine(bin);
+    dftImag[bin] = re * Sine(bin) + im * Cosine(bin);
+  }
+
+  // Rounding errors accumulate in the sliding DFT, recompute it from time to time
+  if (++samplesSinceResync >= dftResyncPeriod) {
+    samplesSinceResync = 0;
+    const int oldest = (dataHead + 1) & (dataLength - 1);
+    for (int bin = 0; bin < dftBins; bin++) {
+      float re = 0.0f;
+      float im = 0.0f;
+      for (int idx = 0; idx < dataLength; idx++) {
+        const float sample = filtered[(oldest + idx) & (dataLength - 1)];
+        re += sample * Cosine(bin * idx);
+        im -= sample * Sine(bin * idx);
+      }
+      dftReal[bin] = re;
+      dftImag[bin] = im;
     }
   }
-  // Compute in place power spectrum
-  ArduinoFFT<float> FFT = ArduinoFFT<float>(vReal.data(), vImag.data(), dataLength, sampleFreq);
-  FFT.compute(FFTDirection::Forward);
-  FFT.complexToMagnitude();
-  FFT.~ArduinoFFT();
-  SpectrumAverage(vReal.data(), spectrum.data(), spectrum.size(), init);
-  peakLocation = 0.0f;
+}
+
+float Ppg::SpectrumPeak(bool init, float& peakWidth) {
+  if (init) {
+    spectralAvgCount = 0;
+  }
+  const auto count = static_cast<float>(spectralAvgCount);
+  // Hanning window applied in the frequency domain: Y[k] = X[k] / 2 - (X[k - 1] + X[k + 1]) / 4
+  for (int bin = 0; bin < dftBins - 1; bin++) {
+    // X[-1] is the conjugate of X[1]
+    const float previousRe = bin > 0 ? dftReal[bin - 1] : dftReal[1];
+    const float previousIm = bin > 0 ? dftImag[bin - 1] : -dftImag[1];
+    const float re = 0.5f * dftReal[bin] - 0.25f * (previousRe + dftReal[bin + 1]);
+    const float im = 0.5f * dftImag[bin] - 0.25f * (previousIm + dftImag[bin + 1]);
+    const float magnitude = sqrtf(re * re + im * im);
+    spectrum[bin] = (spectrum[bin] * count + magnitude) / (count + 1);
+  }
+  if (spectralAvgCount < spectralAvgMax) {
+    spectralAvgCount++;
+  }
+
+  float location = 0.0f;
   float threshold = peakDetectionThreshold;
-  float peakWidth = 0.0f;
   int specLen = spectrum.size();
   float max = SpectrumMax(spectrum, hrROIbegin, hrROIend);
   float signalToNoiseRatio = SignalToNoise(spectrum, hrROIbegin, hrROIend, max);
   if (signalToNoiseRatio > signalToNoiseThreshold && spectrum.at(0) < dcThreshold) {
     threshold *= max;
-    // Reuse VImag for interpolation x values passed to PeakSearch
-    for (int idx = 0; idx < dataLength; idx++) {
-      vImag[idx] = idx;
-    }
-    peakLocation = PeakSearch(vImag.data(),
-                              spectrum.data(),
-                              threshold,
-                              peakWidth,
-                              static_cast<float>(hrROIbegin),
-                              static_cast<float>(hrROIend),
-                              specLen);
-    peakLocation *= freqResolution;
+    location = PeakSearch(spectrum.data(),
+                          threshold,
+                          peakWidth,
+                          static_cast<float>(hrROIbegin),
+                          static_cast<float>(hrROIend),
+                          specLen);
+    location *= freqResolution;
   }
+  return location;
+}
+#endif
+
+// Pass init == true to reset spectral averaging.
+// Returns -1 (Reset Acquisition), 0 (Unable to obtain HR) or HR (BPM).
+int Ppg::ProcessHeartRate(bool init) {
+  float peakWidth = 0.0f;
+  peakLocation = SpectrumPeak(init, peakWidth);
   // Peak too wide? (broad spectrum noise or large, rapid HR change)
   if (peakWidth > maxPeakWidth) {
     peakLocation = 0.0f;
@@ -252,19 +499,6 @@ int Ppg::ProcessHeartRate(bool init) {
   return rtn;
 }
 
-void Ppg::SpectrumAverage(const float* data, float* spectrum, int length, bool reset) {
-  if (reset) {
-    spectralAvgCount = 0;
-  }
-  float count = static_cast<float>(spectralAvgCount);
-  for (int idx = 0; idx < length; idx++) {
-    spectrum[idx] = (spectrum[idx] * count + data[idx]) / (count + 1);
-  }
-  if (spectralAvgCount < spectralAvgMax) {
-    spectralAvgCount++;
-  }
-}
-
 float Ppg::HeartRateAverage(float hr) {
   avgIndex++;
   avgIndex %= dataAverage.size();
@@ -3,11 +3,6 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
-// Note: Change internal define 'sqrt_internal sqrt' to
-// 'sqrt_internal sqrtf' to save ~3KB of flash.
-#define sqrt_internal sqrtf
-#define FFT_SPEED_OVER_PRECISION
-#include "libs/arduinoFFT/src/arduinoFFT.h"
 
 namespace Pinetime {
   namespace Controllers {
@@ -52,14 +47,32 @@ namespace Pinetime {
       // ALS detection factor
       static constexpr float alsFactor = 2.0f;
 
-      // Raw ADC data
+      // Raw ADC data, ring buffer holding the oldest sample at dataHead once full
       std::array<uint16_t, dataLength> dataHRS;
-      // Stores Real numbers from FFT
-      std::array<float, dataLength> vReal;
-      // Stores Imaginary numbers from FFT
-      std::array<float, dataLength> vImag;
-      // Stores power spectrum calculated from FFT real and imag values
+#ifdef HEARTRATE_FIXED_POINT
+      // Filtered and windowed samples (Q8), transformed in place as dataLength / 2 complex values
+      std::array<int32_t, dataLength> frame;
+      // Stores the averaged magnitude spectrum (Q8)
+      std::array<int32_t, spectrumLength> spectrum;
+#else
+      // Bins updated by the sliding DFT: up to the end of the ROI, plus the neighbours needed by
+      // the Hanning window and the interpolation in PeakSearch
+      static constexpr uint16_t dftBins = hrROIend + 3;
+      // Number of samples between two full recomputations of the sliding DFT
+      static constexpr uint16_t dftResyncPeriod = 16 * dataLength;
+      // Band-pass filtered samples, same layout as dataHRS
+      std::array<float, dataLength> filtered {};
+      // Sliding DFT of the filtered samples
+      std::array<float, dftBins> dftReal {};
+      std::array<float, dftBins> dftImag {};
+      // Band-pass filter states
+      std::array<float, 4> lowPassState {};
+      std::array<float, 4> highPassState {};
+      uint16_t lastHrs = 0;
+      uint16_t samplesSinceResync = 0;
+      // Stores the averaged magnitude spectrum
       std::array<float, (spectrumLength)> spectrum;
+#endif
       // Stores each new HR value (Hz). Non zero values are averaged for HR output
       std::array<float, 20> dataAverage;
 
@@ -69,12 +82,18 @@ namespace Pinetime {
       uint16_t alsThreshold = UINT16_MAX;
       uint16_t alsValue = 0;
       uint16_t dataIndex = 0;
+      uint16_t dataHead = 0;
+      uint16_t newSamples = 0;
       float peakLocation;
       bool resetSpectralAvg = true;
 
       int ProcessHeartRate(bool init);
+      // Returns the location (Hz) of the heart rate peak in the averaged spectrum, 0 if none was found
+      float SpectrumPeak(bool init, float& peakWidth);
       float HeartRateAverage(float hr);
-      void SpectrumAverage(const float* data, float* spectrum, int length, bool reset);
+#ifndef HEARTRATE_FIXED_POINT
+      void UpdateSpectrum(uint16_t hrs);
+#endif
     };
   }
 }
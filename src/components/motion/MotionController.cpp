@@ -1,8 +1,10 @@
 #include "components/motion/MotionController.h"
 
+#include <algorithm>
 #include <task.h>
 
 #include "utility/Math.h"
+#include "utility/ChangeBus.h"
 
 using namespace Pinetime::Controllers;
 
@@ -33,28 +35,68 @@ namespace {
     }
     return prevYAngle - yAngle;
   }
+
+  // Sample pushed age samples before the most recent one, which is at index 0 of the history
+  template <typename History>
+  int16_t Age(const History& history, size_t age) {
+    return history[(history.Size() - age) % history.Size()];
+  }
 }
 
 void MotionController::Update(int16_t x, int16_t y, int16_t z, uint32_t nbSteps) {
-  if (this->nbSteps != nbSteps && service != nullptr) {
-    service->OnNewStepCountValue(nbSteps);
-  }
+  const Sample sample {x, y, z};
+  Update({&sample, 1}, nbSteps, 0);
+}
 
-  if (service != nullptr && (xHistory[0] != x || yHistory[0] != y || zHistory[0] != z)) {
-    service->OnNewMotionValues(x, y, z);
+void MotionController::Update(std::span<const Sample> samples, uint32_t nbSteps, uint32_t samplePeriod) {
+  if (this->nbSteps != nbSteps) {
+    if (service != nullptr) {
+      service->OnNewStepCountValue(nbSteps);
+    }
+    Utility::ChangeBus::Publish(Utility::Topic::Steps);
   }
 
-  lastTime = time;
-  time = xTaskGetTickCount();
+  if (!samples.empty()) {
+    const Sample& last = samples.back();
+    if (service != nullptr && (xHistory[0] != last.x || yHistory[0] != last.y || zHistory[0] != last.z)) {
+      service->OnNewMotionValues(last.x, last.y, last.z);
+    }
 
-  xHistory++;
-  xHistory[0] = x;
-  yHistory++;
-  yHistory[0] = y;
-  zHistory++;
-  zHistory[0] = z;
+    lastTime = time;
+    time = xTaskGetTickCount();
 
-  stats = GetAccelStats();
+    if (service != nullptr) {
+      service->OnNewMotionSamples(samples, time);
+    }
+
+    const TickType_t period = (samplePeriod != 0) ? pdMS_TO_TICKS(samplePeriod) : time - lastTime;
+    raiseDetected = false;
+    lowerDetected = false;
+    for (const auto& sample : samples) {
+      // The shake speed is averaged over the samples, whatever the number of samples in each batch
+      if (period != 0) {
+        int32_t speed = std::abs(sample.z - zHistory[0] + (sample.y - yHistory[0]) / 2 + (sample.x - xHistory[0]) / 4) * 100 /
+                        static_cast<int32_t>(period);
+        // (.2 * speed) + ((1 - .2) * accumulatedSpeed);
+        accumulatedSpeed = speed / 5 + accumulatedSpeed * 4 / 5;
+      }
+
+      xSums.Push(xHistory, sample.x);
+      ySums.Push(yHistory, sample.y);
+      zSums.Push(zHistory, sample.z);
+      xHistory++;
+      xHistory[0] = sample.x;
+      yHistory++;
+      yHistory[0] = sample.y;
+      zHistory++;
+      zHistory[0] = sample.z;
+
+      // Check every position of the window in the batch, a roll can happen between two samples of the batch
+      const AccelStats stats = GetAccelStats();
+      raiseDetected = raiseDetected || IsRaised(stats);
+      lowerDetected = lowerDetected || IsLowered(stats);
+    }
+  }
 
   int32_t deltaSteps = nbSteps - this->nbSteps;
   if (deltaSteps > 0) {
@@ -63,37 +105,51 @@ void MotionController::Update(int16_t x, int16_t y, int16_t z, uint32_t nbSteps)
   this->nbSteps = nbSteps;
 }
 
-MotionController::AccelStats MotionController::GetAccelStats() const {
-  AccelStats stats;
+void MotionController::WindowSums::Push(const History& history, int16_t value) {
+  // The sample leaving the recent window becomes numHistory samples old, the one entering the previous window
+  // becomes histSize - numHistory samples old, and the oldest one is overwritten
+  const int32_t leavingRecent = Age(history, AccelStats::numHistory - 1);
+  const int32_t enteringPrevious = Age(history, histSize - AccelStats::numHistory - 1);
+  const int32_t dropped = Age(history, histSize - 1);
+  recent += value - leavingRecent;
+  recentSquares += value * value - leavingRecent * leavingRecent;
+  previous += enteringPrevious - dropped;
+}
 
-  for (uint8_t i = 0; i < AccelStats::numHistory; i++) {
-    stats.xMean += xHistory[histSize - i];
-    stats.yMean += yHistory[histSize - i];
-    stats.zMean += zHistory[histSize - i];
-    stats.prevXMean += xHistory[1 + i];
-    stats.prevYMean += yHistory[1 + i];
-    stats.prevZMean += zHistory[1 + i];
-  }
-  stats.xMean /= AccelStats::numHistory;
-  stats.yMean /= AccelStats::numHistory;
-  stats.zMean /= AccelStats::numHistory;
-  stats.prevXMean /= AccelStats::numHistory;
-  stats.prevYMean /= AccelStats::numHistory;
-  stats.prevZMean /= AccelStats::numHistory;
-
-  for (uint8_t i = 0; i < AccelStats::numHistory; i++) {
-    stats.xVariance += (xHistory[histSize - i] - stats.xMean) * (xHistory[histSize - i] - stats.xMean);
-    stats.yVariance += (yHistory[histSize - i] - stats.yMean) * (yHistory[histSize - i] - stats.yMean);
-    stats.zVariance += (zHistory[histSize - i] - stats.zMean) * (zHistory[histSize - i] - stats.zMean);
-  }
-  stats.xVariance /= AccelStats::numHistory;
-  stats.yVariance /= AccelStats::numHistory;
-  stats.zVariance /= AccelStats::numHistory;
+int16_t MotionController::WindowSums::Mean() const {
+  return recent / AccelStats::numHistory;
+}
+
+int16_t MotionController::WindowSums::PreviousMean() const {
+  return previous / AccelStats::numHistory;
+}
+
+uint32_t MotionController::WindowSums::Variance() const {
+  constexpr int32_t n = AccelStats::numHistory;
+  return static_cast<uint32_t>(n * recentSquares - recent * recent) / (n * n);
+}
 
+MotionController::AccelStats MotionController::GetAccelStats() const {
+  AccelStats stats;
+  stats.xMean = xSums.Mean();
+  stats.yMean = ySums.Mean();
+  stats.zMean = zSums.Mean();
+  stats.prevXMean = xSums.PreviousMean();
+  stats.prevYMean = ySums.PreviousMean();
+  stats.prevZMean = zSums.PreviousMean();
+  stats.xVariance = xSums.Variance();
+  stats.yVariance = ySums.Variance();
+  stats.zVariance = zSums.Variance();
   return stats;
 }
 
-bool MotionController::ShouldRaiseWake() const {
+bool MotionController::ShouldRaiseWake() {
+  bool detected = raiseDetected;
+  raiseDetected = false;
+  return detected;
+}
+
+bool MotionController::IsRaised(const AccelStats& stats) {
   constexpr uint32_t varianceThresh = 56 * 56;
   constexpr int16_t xThresh = 384;
   constexpr int16_t yThresh = -64;
@@ -111,18 +167,17 @@ bool MotionController::ShouldRaiseWake() const {
   return DegreesRolled(stats.yMean, stats.zMean, stats.prevYMean, stats.prevZMean) < rollDegreesThresh;
 }
 
-bool MotionController::ShouldShakeWake(uint16_t thresh) {
-  /* Currently Polling at 10hz, If this ever goes faster scalar and EMA might need adjusting */
-  int32_t speed = std::abs(zHistory[0] - zHistory[histSize - 1] + (yHistory[0] - yHistory[histSize - 1]) / 2 +
-                           (xHistory[0] - xHistory[histSize - 1]) / 4) *
-                  100 / (time - lastTime);
-  // (.2 * speed) + ((1 - .2) * accumulatedSpeed);
-  accumulatedSpeed = speed / 5 + accumulatedSpeed * 4 / 5;
-
+bool MotionController::ShouldShakeWake(uint16_t thresh) const {
   return accumulatedSpeed > thresh;
 }
 
-bool MotionController::ShouldLowerSleep() const {
+bool MotionController::ShouldLowerSleep() {
+  bool detected = lowerDetected;
+  lowerDetected = false;
+  return detected;
+}
+
+bool MotionController::IsLowered(const AccelStats& stats) const {
   if ((stats.xMean > 887 && DegreesRolled(stats.xMean, stats.zMean, stats.prevXMean, stats.prevZMean) > 30) ||
       (stats.xMean < -887 && DegreesRolled(stats.xMean, stats.zMean, stats.prevXMean, stats.prevZMean) < -30)) {
     return true;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 
 #include <FreeRTOS.h>
 
@@ -18,7 +19,12 @@ namespace Pinetime {
         BMA425,
       };
 
+      using Sample = Pinetime::Drivers::Bma421::Sample;
+
       void Update(int16_t x, int16_t y, int16_t z, uint32_t nbSteps);
+      // samples are ordered from the oldest to the most recent, samplePeriod milliseconds apart (0 if unknown, the
+      // time since the previous update is used instead)
+      void Update(std::span<const Sample> samples, uint32_t nbSteps, uint32_t samplePeriod);
 
       int16_t X() const {
         return xHistory[0];
@@ -44,9 +50,10 @@ namespace Pinetime {
         return currentTripSteps;
       }
 
-      bool ShouldShakeWake(uint16_t thresh);
-      bool ShouldRaiseWake() const;
-      bool ShouldLowerSleep() const;
+      bool ShouldShakeWake(uint16_t thresh) const;
+      // Whether the wrist was raised (or lowered) at any sample of the last update. The detection is cleared once read.
+      bool ShouldRaiseWake();
+      bool ShouldLowerSleep();
 
       int32_t CurrentShakeSpeed() const {
         return accumulatedSpeed;
@@ -73,6 +80,9 @@ namespace Pinetime {
       TickType_t lastTime = 0;
       TickType_t time = 0;
 
+      static constexpr uint8_t histSize = 8;
+      using History = Utility::CircularBuffer<int16_t, histSize>;
+
       struct AccelStats {
         static constexpr uint8_t numHistory = 2;
 
@@ -88,14 +98,32 @@ namespace Pinetime {
         uint32_t zVariance = 0;
       };
 
-      AccelStats GetAccelStats() const;
-
-      AccelStats stats = {};
+      // Sums over the numHistory most recent samples and the numHistory oldest samples of a history, updated as each
+      // sample is pushed so that the statistics are cheap enough to be checked at every sample of a batch
+      struct WindowSums {
+        int32_t recent = 0;
+        int32_t recentSquares = 0;
+        int32_t previous = 0;
+
+        // Must be called before value is pushed into history
+        void Push(const History& history, int16_t value);
+        int16_t Mean() const;
+        int16_t PreviousMean() const;
+        uint32_t Variance() const;
+      };
 
-      static constexpr uint8_t histSize = 8;
-      Utility::CircularBuffer<int16_t, histSize> xHistory = {};
-      Utility::CircularBuffer<int16_t, histSize> yHistory = {};
-      Utility::CircularBuffer<int16_t, histSize> zHistory = {};
+      AccelStats GetAccelStats() const;
+      static bool IsRaised(const AccelStats& stats);
+      bool IsLowered(const AccelStats& stats) const;
+
+      History xHistory = {};
+      History yHistory = {};
+      History zHistory = {};
+      WindowSums xSums;
+      WindowSums ySums;
+      WindowSums zSums;
+      bool raiseDetected = false;
+      bool lowerDetected = false;
       int32_t accumulatedSpeed = 0;
 
       DeviceTypes deviceType = DeviceTypes::Unknown;
@@ -50,6 +50,7 @@
 #include "displayapp/screens/settings/SettingChimes.h"
 #include "displayapp/screens/settings/SettingShakeThreshold.h"
 #include "displayapp/screens/settings/SettingBluetooth.h"
+#include "displayapp/ScreenArena.h"
 
 #include "libs/lv_conf.h"
 #include "UserApps.h"
@@ -59,6 +60,22 @@
 using namespace Pinetime::Applications;
 using namespace Pinetime::Applications::Display;
 
+namespace {
+  // Screens built in a ScreenArena. Their objects must not outlive them: screens that style the active
+  // screen object (lv_scr_act()) for example cannot use it.
+  bool UsesScreenArena(Apps app) {
+    switch (app) {
+      case Apps::Launcher:
+      case Apps::Clock:
+      case Apps::Notifications:
+      case Apps::NotificationsPreview:
+        return true;
+      default:
+        return false;
+    }
+  }
+}
+
 namespace {
   inline bool in_isr() {
     return (SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk) != 0;
@@ -126,6 +143,11 @@ DisplayApp::DisplayApp(Drivers::St7789& lcd,
 
 void DisplayApp::Start(System::BootErrors error) {
   msgQueue = xQueueCreate(queueSize, itemSize);
+  Utility::ChangeBus::SetListener(
+    [](void* context) {
+      return static_cast<DisplayApp*>(context)->PushMessage(Messages::ValuesChanged);
+    },
+    this);
 
   bootError = error;
 
@@ -241,6 +263,7 @@ void DisplayApp::Refresh() {
       // If not true, then wait that amount of time
       queueTimeout = CalculateSleepTime();
       if (queueTimeout == 0) {
+        RefreshChangedValues();
         // Only advance the tick count when LVGL is done
         // Otherwise keep running the task handler while it still has things to draw
         // Note: under high graphics load, LVGL will always have more work to do
@@ -257,6 +280,7 @@ void DisplayApp::Refresh() {
       if (!currentScreen->IsRunning()) {
         LoadPreviousScreen();
       }
+      RefreshChangedValues();
       queueTimeout = lv_task_handler();
 
       if (!systemTask->IsSleepDisabled() && IsPastDimTime()) {
@@ -477,6 +501,10 @@ void DisplayApp::Refresh() {
         LoadNewScreen(Apps::Clock, DisplayApp::FullRefreshDirections::None);
         motorController.RunForDuration(35);
         break;
+      case Messages::ValuesChanged:
+        // Only wakes the task up, the changes are handled at the top of the loop.
+        // While the display is off they stay pending until it wakes up.
+        break;
     }
   }
 
@@ -511,9 +539,17 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
   lv_disp_trig_activity(nullptr);
   motorController.StopRinging();
 
+#if NRF_LOG_ENABLED
+  LogFrameStats();
+#endif
   currentScreen.reset(nullptr);
+  ScreenArena::Release();
   SetFullRefresh(direction);
 
+  if (UsesScreenArena(app)) {
+    ScreenArena::Open();
+  }
+
   switch (app) {
     case Apps::Launcher: {
       std::array<Screens::Tile::Applications, UserAppTypes::Count> apps;
@@ -649,24 +685,54 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
       break;
     }
   }
+  ScreenArena::Close();
   currentApp = app;
 }
 
-void DisplayApp::PushMessage(Messages msg) {
+#if NRF_LOG_ENABLED
+void DisplayApp::LogFrameStats() {
+  const auto& stats = lvgl.GetFrameStats();
+  if (stats.frames > 0) {
+    NRF_LOG_INFO("Screen %d : %d frames, render time %d ms (max %d), %d px rendered",
+                 static_cast<int>(currentApp),
+                 stats.frames,
+                 stats.renderTime,
+                 stats.maxRenderTime,
+                 stats.renderedPixels);
+    NRF_LOG_INFO("Screen %d : %d px flushed in %d bands, free heap %d (min %d)",
+                 static_cast<int>(currentApp),
+                 stats.flushedPixels,
+                 stats.flushes,
+                 xPortGetFreeHeapSize(),
+                 xPortGetMinimumEverFreeHeapSize());
+  }
+  lvgl.ResetFrameStats();
+}
+#endif
+
+void DisplayApp::RefreshChangedValues() {
+  auto changes = Utility::ChangeBus::TakeChanges();
+  if (changes != 0) {
+    currentScreen->OnValuesChanged(changes);
+  }
+}
+
+bool DisplayApp::PushMessage(Messages msg) {
   if (in_isr()) {
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    xQueueSendFromISR(msgQueue, &msg, &xHigherPriorityTaskWoken);
+    BaseType_t result = xQueueSendFromISR(msgQueue, &msg, &xHigherPriorityTaskWoken);
     portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    return result == pdTRUE;
   } else {
     TickType_t timeout = portMAX_DELAY;
     // Make xQueueSend() non-blocking if the message is a Notification message. We do this to avoid
     // deadlock between SystemTask and DisplayApp when their respective message queues are getting full
     // when a lot of notifications are received on a very short time span.
-    if (msg == Messages::NewNotification) {
+    if (msg == Messages::NewNotification || msg == Messages::ValuesChanged) {
       timeout = static_cast<TickType_t>(0);
     }
 
-    xQueueSend(msgQueue, &msg, timeout);
+    return xQueueSend(msgQueue, &msg, timeout) == pdTRUE;
   }
 }
 
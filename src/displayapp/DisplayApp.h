@@ -69,7 +69,8 @@ namespace Pinetime {
                  Pinetime::Controllers::FS& filesystem,
                  Pinetime::Drivers::SpiNorFlash& spiNorFlash);
       void Start(System::BootErrors error);
-      void PushMessage(Display::Messages msg);
+      // Returns false if the message was dropped because the queue was full
+      bool PushMessage(Display::Messages msg);
 
       void StartApp(Apps app, DisplayApp::FullRefreshDirections direction);
 
@@ -125,6 +126,10 @@ namespace Pinetime {
       void Refresh();
       void LoadNewScreen(Apps app, DisplayApp::FullRefreshDirections direction);
       void LoadScreen(Apps app, DisplayApp::FullRefreshDirections direction);
+#if NRF_LOG_ENABLED
+      void LogFrameStats();
+#endif
+      void RefreshChangedValues();
       void PushMessageToSystemTask(Pinetime::System::Messages message);
 
       Apps nextApp = Apps::None;
@@ -3,6 +3,7 @@
 
 #include <FreeRTOS.h>
 #include <task.h>
+#include <algorithm>
 #include "drivers/St7789.h"
 #include "littlefs/lfs.h"
 #include "components/fs/FS.h"
@@ -58,6 +59,18 @@ static void disp_flush(lv_disp_drv_t* disp_drv, const lv_area_t* area, lv_color_
   lvgl->FlushDisplay(area, color_p);
 }
 
+static void disp_wait(lv_disp_drv_t* disp_drv) {
+  auto* lvgl = static_cast<LittleVgl*>(disp_drv->user_data);
+  lvgl->WaitFlushDone();
+}
+
+#if NRF_LOG_ENABLED
+static void monitor(lv_disp_drv_t* disp_drv, uint32_t time, uint32_t px) {
+  auto* lvgl = static_cast<LittleVgl*>(disp_drv->user_data);
+  lvgl->OnFrameRendered(time, px);
+}
+#endif
+
 static void rounder(lv_disp_drv_t* disp_drv, lv_area_t* area) {
   auto* lvgl = static_cast<LittleVgl*>(disp_drv->user_data);
   if (lvgl->GetFullRefresh()) {
@@ -85,8 +98,10 @@ void LittleVgl::Init() {
 }
 
 void LittleVgl::InitDisplay() {
-  lv_disp_buf_init(&disp_buf_2, buf2_1, buf2_2, LV_HOR_RES_MAX * 4); /*Initialize the display buffer*/
-  lv_disp_drv_init(&disp_drv);                                       /*Basic initialization*/
+  flushDone = xSemaphoreCreateBinary();
+
+  lv_disp_buf_init(&disp_buf_2, buf2_1, buf2_2, LV_HOR_RES_MAX * nbWriteLines); /*Initialize the display buffer*/
+  lv_disp_drv_init(&disp_drv);                                                  /*Basic initialization*/
 
   /*Set up the functions to access to your display*/
 
@@ -100,6 +115,12 @@ void LittleVgl::InitDisplay() {
   disp_drv.buffer = &disp_buf_2;
   disp_drv.user_data = this;
   disp_drv.rounder_cb = rounder;
+  /*Sleep instead of spinning while waiting for a buffer to be flushed*/
+  disp_drv.wait_cb = disp_wait;
+#if NRF_LOG_ENABLED
+  /*Collect rendering statistics after each refresh*/
+  disp_drv.monitor_cb = monitor;
+#endif
 
   /*Finally register the driver*/
   lv_disp_drv_register(&disp_drv);
@@ -163,6 +184,10 @@ void LittleVgl::FlushDisplay(const lv_area_t* area, lv_color_t* color_p) {
 
   width = (area->x2 - area->x1) + 1;
   height = (area->y2 - area->y1) + 1;
+#if NRF_LOG_ENABLED
+  frameStats.flushes++;
+  frameStats.flushedPixels += width * height;
+#endif
 
   if (scrollDirection == LittleVgl::FullRefreshDirections::Down) {
 
@@ -210,6 +235,13 @@ void LittleVgl::FlushDisplay(const lv_area_t* area, lv_color_t* color_p) {
     }
   }
 
+  // IMPORTANT!!!
+  // The graphics library is informed that the flushing is done from the SPI interrupt, once the buffer is sent.
+  // Meanwhile, it can render the next band in the other buffer.
+  auto onFlushDone = [this]() {
+    OnFlushDone();
+  };
+
   if (y2 < y1) {
     height = totalNbLines - y1;
 
@@ -219,15 +251,34 @@ void LittleVgl::FlushDisplay(const lv_area_t* area, lv_color_t* color_p) {
 
     uint16_t pixOffset = width * height;
     height = y2 + 1;
-    lcd.DrawBuffer(area->x1, 0, width, height, reinterpret_cast<const uint8_t*>(color_p + pixOffset), width * height * 2);
+    lcd.DrawBuffer(area->x1, 0, width, height, reinterpret_cast<const uint8_t*>(color_p + pixOffset), width * height * 2, onFlushDone);
 
   } else {
-    lcd.DrawBuffer(area->x1, y1, width, height, reinterpret_cast<const uint8_t*>(color_p), width * height * 2);
+    lcd.DrawBuffer(area->x1, y1, width, height, reinterpret_cast<const uint8_t*>(color_p), width * height * 2, onFlushDone);
   }
+}
 
-  // IMPORTANT!!!
-  // Inform the graphics library that you are ready with the flushing
+#if NRF_LOG_ENABLED
+void LittleVgl::OnFrameRendered(uint32_t time, uint32_t pixels) {
+  frameStats.frames++;
+  frameStats.renderTime += time;
+  frameStats.maxRenderTime = std::max(frameStats.maxRenderTime, time);
+  frameStats.renderedPixels += pixels;
+}
+#endif
+
+// Called from the SPI interrupt
+void LittleVgl::OnFlushDone() {
   lv_disp_flush_ready(&disp_drv);
+
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+  xSemaphoreGiveFromISR(flushDone, &xHigherPriorityTaskWoken);
+  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+// Called by LVGL in a loop as long as the buffer it needs is being flushed
+void LittleVgl::WaitFlushDone() {
+  xSemaphoreTake(flushDone, pdMS_TO_TICKS(5));
 }
 
 void LittleVgl::SetNewTouchPoint(int16_t x, int16_t y, bool contact) {
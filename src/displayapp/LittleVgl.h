@@ -1,8 +1,15 @@
 #pragma once
 
+#include <FreeRTOS.h>
+#include <semphr.h>
 #include <lvgl/lvgl.h>
 #include <components/fs/FS.h>
 
+// Number of display lines rendered by LVGL in each of the 2 draw buffers (can be set with -DDISPLAY_BAND_HEIGHT)
+#ifndef DISPLAY_BAND_HEIGHT
+  #define DISPLAY_BAND_HEIGHT 4
+#endif
+
 namespace Pinetime {
   namespace Drivers {
     class St7789;
@@ -12,6 +19,19 @@ namespace Pinetime {
     class LittleVgl {
     public:
       enum class FullRefreshDirections { None, Up, Down, Left, Right, LeftAnim, RightAnim };
+
+#if NRF_LOG_ENABLED
+      // Rendering statistics since the last call to ResetFrameStats(), only collected in debug builds
+      struct FrameStats {
+        uint32_t frames = 0;
+        uint32_t renderTime = 0; // Total time spent rendering and flushing, in ticks (~ms)
+        uint32_t maxRenderTime = 0;
+        uint32_t renderedPixels = 0; // Pixels redrawn by LVGL
+        uint32_t flushes = 0;        // Number of bands sent to the display
+        uint32_t flushedPixels = 0;  // Pixels sent to the display
+      };
+#endif
+
       LittleVgl(Pinetime::Drivers::St7789& lcd, Pinetime::Controllers::FS& filesystem);
 
       LittleVgl(const LittleVgl&) = delete;
@@ -22,11 +42,23 @@ namespace Pinetime {
       void Init();
 
       void FlushDisplay(const lv_area_t* area, lv_color_t* color_p);
+      void WaitFlushDone();
       bool GetTouchPadInfo(lv_indev_data_t* ptr);
       void SetFullRefresh(FullRefreshDirections direction);
       void SetNewTouchPoint(int16_t x, int16_t y, bool contact);
       void CancelTap();
       void ClearTouchState();
+#if NRF_LOG_ENABLED
+      void OnFrameRendered(uint32_t time, uint32_t pixels);
+
+      const FrameStats& GetFrameStats() const {
+        return frameStats;
+      }
+
+      void ResetFrameStats() {
+        frameStats = {};
+      }
+#endif
 
       bool GetFullRefresh() {
         bool returnValue = fullRefresh;
@@ -40,20 +72,25 @@ namespace Pinetime {
       void InitDisplay();
       void InitTouchpad();
       void InitFileSystem();
+      void OnFlushDone();
 
       Pinetime::Drivers::St7789& lcd;
       Pinetime::Controllers::FS& filesystem;
 
+      static constexpr uint8_t nbWriteLines = DISPLAY_BAND_HEIGHT;
+      static constexpr uint16_t totalNbLines = 320;
+      static constexpr uint16_t visibleNbLines = 240;
+      static_assert(visibleNbLines % nbWriteLines == 0, "The band height must divide the height of the display");
+
+      // LVGL renders into one buffer while the other one is being sent to the display by DMA
       lv_disp_buf_t disp_buf_2;
-      lv_color_t buf2_1[LV_HOR_RES_MAX * 4];
-      lv_color_t buf2_2[LV_HOR_RES_MAX * 4];
+      lv_color_t buf2_1[LV_HOR_RES_MAX * nbWriteLines];
+      lv_color_t buf2_2[LV_HOR_RES_MAX * nbWriteLines];
 
       lv_disp_drv_t disp_drv;
+      SemaphoreHandle_t flushDone = nullptr;
 
       bool fullRefresh = false;
-      static constexpr uint8_t nbWriteLines = 4;
-      static constexpr uint16_t totalNbLines = 320;
-      static constexpr uint16_t visibleNbLines = 240;
 
       static constexpr uint8_t MaxScrollOffset() {
         return LV_VER_RES_MAX - nbWriteLines;
@@ -66,6 +103,10 @@ namespace Pinetime {
       lv_point_t touchPoint = {};
       bool tapped = false;
       bool isCancelled = false;
+
+#if NRF_LOG_ENABLED
+      FrameStats frameStats;
+#endif
     };
   }
 }
@@ -0,0 +1,139 @@
+#include "displayapp/LvglPool.h"
+#include <array>
+#include <cstdint>
+#include <FreeRTOS.h>
+#include <task.h>
+#include "displayapp/ScreenArena.h"
+
+namespace {
+  struct FreeObject {
+    FreeObject* next;
+  };
+
+  // A slab is a single heap block holding the objects of one size class.
+  // Each object starts with a pointer to its slab (nullptr for the allocations forwarded to the heap).
+  struct Slab {
+    Slab* next; // Next slab of the same class with free objects
+    FreeObject* freeObjects;
+    uint16_t used;
+    uint8_t sizeClass;
+  };
+
+  using Header = Slab*;
+
+  // Object sizes, header included
+  constexpr std::array<size_t, 7> objectSizes {16, 24, 32, 48, 64, 96, 128};
+  constexpr size_t slabSize = 1024;
+  constexpr size_t slabHeaderSize = (sizeof(Slab) + 7) & ~size_t {7};
+
+  // Slabs that still have free objects, for each size class
+  std::array<Slab*, objectSizes.size()> partialSlabs {};
+
+  size_t SizeClass(size_t size) {
+    size_t sizeClass = 0;
+    while (sizeClass < objectSizes.size() && size > objectSizes[sizeClass]) {
+      sizeClass++;
+    }
+    return sizeClass;
+  }
+
+  Slab* NewSlab(size_t sizeClass) {
+    auto* slab = static_cast<Slab*>(pvPortMalloc(slabSize));
+    if (slab == nullptr) {
+      return nullptr;
+    }
+    slab->next = nullptr;
+    slab->freeObjects = nullptr;
+    slab->used = 0;
+    slab->sizeClass = static_cast<uint8_t>(sizeClass);
+
+    auto* data = reinterpret_cast<uint8_t*>(slab);
+    for (size_t offset = slabHeaderSize; offset + objectSizes[sizeClass] <= slabSize; offset += objectSizes[sizeClass]) {
+      auto* object = reinterpret_cast<FreeObject*>(data + offset);
+      object->next = slab->freeObjects;
+      slab->freeObjects = object;
+    }
+    return slab;
+  }
+
+  void RemovePartialSlab(Slab* slab) {
+    Slab** link = &partialSlabs[slab->sizeClass];
+    while (*link != slab) {
+      link = &(*link)->next;
+    }
+    *link = slab->next;
+  }
+}
+
+void* LvglPoolAlloc(size_t size) {
+  size_t totalSize = size + sizeof(Header);
+  size_t sizeClass = SizeClass(totalSize);
+  Header* header = nullptr;
+
+  // Objects created by a screen that uses an arena are released with it
+  header = static_cast<Header*>(Pinetime::Applications::ScreenArena::Allocate(totalSize));
+  if (header != nullptr) {
+    *header = nullptr;
+    return header + 1;
+  }
+
+  vTaskSuspendAll();
+  if (sizeClass == objectSizes.size()) {
+    header = static_cast<Header*>(pvPortMalloc(totalSize));
+    if (header != nullptr) {
+      *header = nullptr;
+    }
+  } else {
+    Slab* slab = partialSlabs[sizeClass];
+    if (slab == nullptr) {
+      slab = NewSlab(sizeClass);
+      partialSlabs[sizeClass] = slab;
+    }
+    if (slab != nullptr) {
+      FreeObject* object = slab->freeObjects;
+      slab->freeObjects = object->next;
+      slab->used++;
+      if (slab->freeObjects == nullptr) {
+        partialSlabs[sizeClass] = slab->next;
+      }
+      header = reinterpret_cast<Header*>(object);
+      *header = slab;
+    }
+  }
+  xTaskResumeAll();
+
+  return (header != nullptr) ? header + 1 : nullptr;
+}
+
+void LvglPoolFree(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  Header* header = static_cast<Header*>(ptr) - 1;
+  if (Pinetime::Applications::ScreenArena::Contains(header)) {
+    return;
+  }
+  Slab* slab = *header;
+
+  vTaskSuspendAll();
+  if (slab == nullptr) {
+    vPortFree(header);
+  } else {
+    bool wasFull = (slab->freeObjects == nullptr);
+    auto* object = reinterpret_cast<FreeObject*>(header);
+    object->next = slab->freeObjects;
+    slab->freeObjects = object;
+    slab->used--;
+
+    if (wasFull) {
+      slab->next = partialSlabs[slab->sizeClass];
+      partialSlabs[slab->sizeClass] = slab;
+    } else if (slab->used == 0 && (partialSlabs[slab->sizeClass] != slab || slab->next != nullptr)) {
+      // Give empty slabs back to the heap, but keep the last one of the class to avoid
+      // allocating a new slab each time a single object is created and destroyed
+      RemovePartialSlab(slab);
+      vPortFree(slab);
+    }
+  }
+  xTaskResumeAll();
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stddef.h>
+
+// Memory allocator used by LVGL (LV_MEM_CUSTOM_ALLOC and LV_MEM_CUSTOM_FREE in lv_conf.h).
+// Small allocations (objects, styles, labels...) are served from slabs of fixed size objects, so that creating and
+// destroying the screens does not fragment the FreeRTOS heap. Larger allocations are forwarded to pvPortMalloc().
+// While a screen arena is open, allocations are served from the arena first (see ScreenArena.h).
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void* LvglPoolAlloc(size_t size);
+void LvglPoolFree(void* ptr);
+
+#ifdef __cplusplus
+}
+#endif
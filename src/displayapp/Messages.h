@@ -24,6 +24,8 @@ namespace Pinetime {
         AlarmTriggered,
         Chime,
         BleRadioEnableToggle,
+        // Controller values changed (see utility/ChangeBus.h)
+        ValuesChanged,
       };
     }
   }
@@ -0,0 +1,65 @@
+#include "displayapp/ScreenArena.h"
+#include <cstdint>
+#include <FreeRTOS.h>
+#include <task.h>
+
+using namespace Pinetime::Applications;
+
+namespace {
+  constexpr size_t arenaSize = 4096;
+  constexpr size_t alignment = 8;
+
+  uint8_t* arena = nullptr;
+  size_t arenaCapacity = 0;
+  size_t arenaUsed = 0;
+  // Task served by the arena, nullptr when it is closed
+  TaskHandle_t owner = nullptr;
+}
+
+void ScreenArena::Open() {
+  Release();
+  arena = static_cast<uint8_t*>(pvPortMalloc(arenaSize));
+  if (arena != nullptr) {
+    arenaCapacity = arenaSize;
+    owner = xTaskGetCurrentTaskHandle();
+  }
+}
+
+void ScreenArena::Close() {
+  owner = nullptr;
+  if (arena == nullptr) {
+    return;
+  }
+  if (arenaUsed == 0) {
+    Release();
+    return;
+  }
+  vPortShrink(arena, arenaUsed);
+  arenaCapacity = arenaUsed;
+}
+
+void ScreenArena::Release() {
+  vPortFree(arena);
+  arena = nullptr;
+  arenaCapacity = 0;
+  arenaUsed = 0;
+  owner = nullptr;
+}
+
+void* ScreenArena::Allocate(size_t size) {
+  if (owner == nullptr || xTaskGetCurrentTaskHandle() != owner) {
+    return nullptr;
+  }
+  size = (size + alignment - 1) & ~(alignment - 1);
+  if (size > arenaCapacity - arenaUsed) {
+    return nullptr;
+  }
+  void* ptr = arena + arenaUsed;
+  arenaUsed += size;
+  return ptr;
+}
+
+bool ScreenArena::Contains(const void* ptr) {
+  auto* p = static_cast<const uint8_t*>(ptr);
+  return p >= arena && p < arena + arenaCapacity;
+}
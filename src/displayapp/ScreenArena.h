@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Pinetime {
+  namespace Applications {
+    // Bump allocator for the screens that opt in (see DisplayApp::LoadScreen).
+    // While the arena is open, the allocations of the task that opened it (the Screen object and the LVGL objects it
+    // creates) are carved out of a single heap block. Freeing them is a no-op: the whole block is given back to the heap
+    // at once when the screen is destroyed. Allocations that do not fit fall back to the heap.
+    namespace ScreenArena {
+      void Open();
+      // Stops serving allocations and gives the unused end of the block back to the heap
+      void Close();
+      void Release();
+
+      // Returns nullptr if the arena is closed or full
+      void* Allocate(size_t size);
+      bool Contains(const void* ptr);
+    }
+  }
+}
@@ -0,0 +1,242 @@
+#include "displayapp/StreamedFont.h"
+
+#include <algorithm>
+#include <cstring>
+#include "components/fs/FS.h"
+
+using namespace Pinetime::Components;
+
+namespace {
+  constexpr char magic[4] = {'I', 'F', 'N', 'T'};
+  constexpr uint16_t version = 1;
+}
+
+StreamedFont::~StreamedFont() {
+  Close();
+}
+
+bool StreamedFont::ReadHeader(Controllers::FS& filesystem, lfs_file_t* file, Header& header) {
+  if (filesystem.FileRead(file, reinterpret_cast<uint8_t*>(&header), sizeof(Header)) != static_cast<int>(sizeof(Header))) {
+    return false;
+  }
+  return std::memcmp(header.magic, magic, sizeof(magic)) == 0 && header.version == version && header.glyphCount < noGlyph &&
+         (header.bpp == 1 || header.bpp == 2 || header.bpp == 4 || header.bpp == 8);
+}
+
+bool StreamedFont::IsAvailable(Controllers::FS& filesystem, const char* path) {
+  lfs_file_t file = {};
+  if (filesystem.FileOpen(&file, path, LFS_O_RDONLY) != LFS_ERR_OK) {
+    return false;
+  }
+  Header header;
+  bool valid = ReadHeader(filesystem, &file, header);
+  filesystem.FileClose(&file);
+  return valid;
+}
+
+lv_font_t* StreamedFont::Open(Controllers::FS& filesystem, const char* path, size_t cacheSize) {
+  Close();
+  this->filesystem = &filesystem;
+  this->path = path;
+  this->cacheSize = cacheSize;
+  if (!Load()) {
+    Close();
+    return nullptr;
+  }
+  return &font;
+}
+
+void StreamedFont::Close() {
+  Release();
+  filesystem = nullptr;
+  path = nullptr;
+}
+
+bool StreamedFont::Load() {
+  modificationCount = filesystem->ModificationCount();
+  if (filesystem->FileOpen(&file, path, LFS_O_RDONLY) != LFS_ERR_OK) {
+    return false;
+  }
+  fileOpen = true;
+
+  Header header;
+  if (!ReadHeader(*filesystem, &file, header)) {
+    Release();
+    return false;
+  }
+
+  // The ranges and the glyph descriptors directly follow the header
+  const size_t indexSize = header.rangeCount * sizeof(Range) + header.glyphCount * sizeof(Glyph);
+  index = static_cast<uint8_t*>(lv_mem_alloc(indexSize));
+  if (index == nullptr || filesystem->FileRead(&file, index, indexSize) != static_cast<int>(indexSize)) {
+    Release();
+    return false;
+  }
+  ranges = reinterpret_cast<Range*>(index);
+  glyphs = reinterpret_cast<Glyph*>(index + header.rangeCount * sizeof(Range));
+  rangeCount = header.rangeCount;
+  glyphCount = header.glyphCount;
+  bitmapsOffset = header.bitmapsOffset;
+  bpp = header.bpp;
+
+  // The cache never needs more room than all the bitmaps, nor more entries than glyphs
+  size_t largestBitmap = 0;
+  size_t allBitmaps = 0;
+  for (uint16_t i = 0; i < glyphCount; i++) {
+    const size_t bitmapSize = glyphs[i].bitmapSize;
+    largestBitmap = std::max(largestBitmap, bitmapSize);
+    allBitmaps += bitmapSize;
+  }
+  if (largestBitmap > 0) {
+    const size_t capacity = std::min(std::max(cacheSize, minCachedGlyphs * largestBitmap), allBitmaps);
+    cacheCapacity = static_cast<uint16_t>(std::min<size_t>(capacity, UINT16_MAX));
+    entryCapacity = std::min(glyphCount, maxCacheEntries);
+    cache = static_cast<uint8_t*>(lv_mem_alloc(entryCapacity * sizeof(CacheEntry) + cacheCapacity));
+    if (cache == nullptr) {
+      Release();
+      return false;
+    }
+    entries = reinterpret_cast<CacheEntry*>(cache);
+    bitmaps = cache + entryCapacity * sizeof(CacheEntry);
+    entryCount = 0;
+    cacheUsed = 0;
+  }
+
+  font = {};
+  font.get_glyph_dsc = GetGlyphDescriptor;
+  font.get_glyph_bitmap = GetGlyphBitmap;
+  font.line_height = header.lineHeight;
+  font.base_line = header.baseLine;
+  font.subpx = LV_FONT_SUBPX_NONE;
+  font.underline_position = header.underlinePosition;
+  font.underline_thickness = header.underlineThickness;
+  font.dsc = this;
+  return true;
+}
+
+void StreamedFont::Release() {
+  if (fileOpen) {
+    filesystem->FileClose(&file);
+    fileOpen = false;
+  }
+  if (index != nullptr) {
+    lv_mem_free(index);
+    index = nullptr;
+  }
+  if (cache != nullptr) {
+    lv_mem_free(cache);
+    cache = nullptr;
+  }
+  ranges = nullptr;
+  glyphs = nullptr;
+  entries = nullptr;
+  bitmaps = nullptr;
+  rangeCount = 0;
+  glyphCount = 0;
+  entryCapacity = 0;
+  entryCount = 0;
+  cacheCapacity = 0;
+  cacheUsed = 0;
+}
+
+bool StreamedFont::IsModified() const {
+  return filesystem != nullptr && filesystem->ModificationCount() != modificationCount;
+}
+
+void StreamedFont::ReloadIfModified() {
+  if (!IsModified()) {
+    return;
+  }
+  // The font struct stays at the same address, so the labels using it don't need to be updated.
+  // If the file can't be loaded (it's still being written), no glyph is found until the next modification.
+  Release();
+  Load();
+}
+
+const StreamedFont::Glyph* StreamedFont::FindGlyph(uint32_t codePoint) const {
+  for (uint16_t i = 0; i < rangeCount; i++) {
+    const Range& range = ranges[i];
+    if (codePoint >= range.firstCodePoint && codePoint - range.firstCodePoint < range.length) {
+      uint32_t glyph = range.firstGlyph + (codePoint - range.firstCodePoint);
+      return glyph < glyphCount ? &glyphs[glyph] : nullptr;
+    }
+  }
+  return nullptr;
+}
+
+const uint8_t* StreamedFont::LoadBitmap(const Glyph* glyph) {
+  if (glyph->bitmapSize == 0 || entryCapacity == 0) {
+    return nullptr;
+  }
+
+  const auto glyphIndex = static_cast<uint16_t>(glyph - glyphs);
+  useCounter++;
+  for (uint16_t i = 0; i < entryCount; i++) {
+    if (entries[i].glyph == glyphIndex) {
+      entries[i].lastUse = useCounter;
+      return &bitmaps[entries[i].offset];
+    }
+  }
+
+  // Make room at the end of the cache by evicting the least recently used bitmaps
+  while (entryCount == entryCapacity || cacheUsed + glyph->bitmapSize > cacheCapacity) {
+    uint16_t leastRecentlyUsed = 0;
+    for (uint16_t i = 1; i < entryCount; i++) {
+      if (useCounter - entries[i].lastUse > useCounter - entries[leastRecentlyUsed].lastUse) {
+        leastRecentlyUsed = i;
+      }
+    }
+    Evict(leastRecentlyUsed);
+  }
+
+  uint8_t* bitmap = &bitmaps[cacheUsed];
+  if (filesystem->FileSeek(&file, bitmapsOffset + glyph->bitmapOffset) < 0 ||
+      filesystem->FileRead(&file, bitmap, glyph->bitmapSize) != glyph->bitmapSize) {
+    return nullptr;
+  }
+  entries[entryCount++] = {glyphIndex, cacheUsed, useCounter};
+  cacheUsed += glyph->bitmapSize;
+  return bitmap;
+}
+
+void StreamedFont::Evict(uint16_t entry) {
+  // Move the following bitmaps down over the evicted one, so that the free space stays at the end
+  const uint16_t offset = entries[entry].offset;
+  const uint16_t size = ((entry + 1 < entryCount) ? entries[entry + 1].offset : cacheUsed) - offset;
+  std::memmove(&bitmaps[offset], &bitmaps[offset + size], cacheUsed - offset - size);
+  for (uint16_t i = entry + 1; i < entryCount; i++) {
+    entries[i - 1] = {entries[i].glyph, static_cast<uint16_t>(entries[i].offset - size), entries[i].lastUse};
+  }
+  entryCount--;
+  cacheUsed -= size;
+}
+
+bool StreamedFont::GetGlyphDescriptor(const lv_font_t* font, lv_font_glyph_dsc_t* descriptor, uint32_t letter, uint32_t /*nextLetter*/) {
+  auto* self = static_cast<StreamedFont*>(font->dsc);
+  self->ReloadIfModified();
+  const Glyph* glyph = self->FindGlyph(letter);
+  if (glyph == nullptr) {
+    return false;
+  }
+  // Rounded to the nearest pixel, as done by the built-in LVGL fonts
+  descriptor->adv_w = (glyph->advanceWidth + (1 << 3)) >> 4;
+  descriptor->box_w = glyph->boxWidth;
+  descriptor->box_h = glyph->boxHeight;
+  descriptor->ofs_x = glyph->offsetX;
+  descriptor->ofs_y = glyph->offsetY;
+  descriptor->bpp = self->bpp;
+  return true;
+}
+
+const uint8_t* StreamedFont::GetGlyphBitmap(const lv_font_t* font, uint32_t letter) {
+  auto* self = static_cast<StreamedFont*>(font->dsc);
+  // The descriptor LVGL got for this glyph may not match the file anymore, skip it until it's looked up again
+  if (self->IsModified()) {
+    return nullptr;
+  }
+  const Glyph* glyph = self->FindGlyph(letter);
+  if (glyph == nullptr) {
+    return nullptr;
+  }
+  return self->LoadBitmap(glyph);
+}
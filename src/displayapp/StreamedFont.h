@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <lvgl/lvgl.h>
+#include <littlefs/lfs.h>
+
+namespace Pinetime {
+  namespace Controllers {
+    class FS;
+  }
+
+  namespace Components {
+    // Font loaded from the external flash, in the "stream" layout generated by resources/generate-fonts.py.
+    // Unlike lv_font_load(), which reads the whole font into memory, only the code point ranges and the glyph
+    // descriptors are kept in RAM. The bitmaps are read from the file when LVGL draws the glyphs, into a small
+    // LRU cache whose size is bounded by the cache size given to Open().
+    // LVGL fetches the bitmap of each glyph again for every band of DISPLAY_BAND_HEIGHT lines it draws, so the cache
+    // must hold all the glyphs of a label, or every band misses. Each glyph only takes the size of its own bitmap,
+    // and the cache can always hold at least minCachedGlyphs of the largest glyphs.
+    // When the filesystem is modified (e.g. a font uploaded over BLE), the file is reopened before the next glyph is
+    // looked up, so that the index in RAM always matches the bitmaps in the file.
+    class StreamedFont {
+    public:
+      static constexpr size_t defaultCacheSize = 4096;
+
+      StreamedFont() = default;
+      ~StreamedFont();
+
+      StreamedFont(const StreamedFont&) = delete;
+      StreamedFont& operator=(const StreamedFont&) = delete;
+      StreamedFont(StreamedFont&&) = delete;
+      StreamedFont& operator=(StreamedFont&&) = delete;
+
+      // Returns nullptr if the file doesn't exist or is not a streamed font. The path must stay valid until Close().
+      lv_font_t* Open(Controllers::FS& filesystem, const char* path, size_t cacheSize = defaultCacheSize);
+      void Close();
+
+      static bool IsAvailable(Controllers::FS& filesystem, const char* path);
+
+    private:
+      struct __attribute__((packed)) Header {
+        char magic[4];
+        uint16_t version;
+        uint16_t rangeCount;
+        uint16_t glyphCount;
+        int16_t lineHeight;
+        int16_t baseLine;
+        int8_t underlinePosition;
+        uint8_t underlineThickness;
+        uint8_t bpp;
+        uint8_t reserved;
+        uint32_t bitmapsOffset;
+      };
+
+      struct __attribute__((packed)) Range {
+        uint32_t firstCodePoint;
+        uint16_t length;
+        uint16_t firstGlyph;
+      };
+
+      struct __attribute__((packed)) Glyph {
+        uint32_t bitmapOffset;
+        uint16_t bitmapSize;
+        uint16_t advanceWidth; // 1/16 px
+        uint8_t boxWidth;
+        uint8_t boxHeight;
+        int8_t offsetX;
+        int8_t offsetY;
+      };
+
+      // Bitmaps are packed in the cache in the order of the entries, without gaps
+      struct CacheEntry {
+        uint16_t glyph;
+        uint16_t offset;
+        uint32_t lastUse;
+      };
+
+      static constexpr uint16_t noGlyph = 0xffff;
+      static constexpr size_t minCachedGlyphs = 6; // "12:34" and "-12:34" fit
+      static constexpr uint16_t maxCacheEntries = 32;
+
+      static bool ReadHeader(Controllers::FS& filesystem, lfs_file_t* file, Header& header);
+      static bool GetGlyphDescriptor(const lv_font_t* font, lv_font_glyph_dsc_t* descriptor, uint32_t letter, uint32_t nextLetter);
+      static const uint8_t* GetGlyphBitmap(const lv_font_t* font, uint32_t letter);
+
+      bool Load();
+      void Release();
+      void ReloadIfModified();
+      bool IsModified() const;
+      const Glyph* FindGlyph(uint32_t codePoint) const;
+      const uint8_t* LoadBitmap(const Glyph* glyph);
+      void Evict(uint16_t entry);
+
+      Controllers::FS* filesystem = nullptr;
+      const char* path = nullptr;
+      size_t cacheSize = 0;
+      uint32_t modificationCount = 0;
+      bool fileOpen = false;
+      lfs_file_t file = {};
+      lv_font_t font = {};
+
+      uint32_t bitmapsOffset = 0;
+      uint8_t bpp = 1;
+      uint16_t rangeCount = 0;
+      uint16_t glyphCount = 0;
+      uint16_t entryCapacity = 0;
+      uint16_t entryCount = 0;
+      uint16_t cacheCapacity = 0;
+      uint16_t cacheUsed = 0;
+      uint32_t useCounter = 0;
+
+      // Resident index: the ranges followed by the glyph descriptors
+      uint8_t* index = nullptr;
+      Range* ranges = nullptr;
+      Glyph* glyphs = nullptr;
+      // Cache: entryCapacity entries followed by cacheCapacity bytes of bitmaps
+      uint8_t* cache = nullptr;
+      CacheEntry* entries = nullptr;
+      uint8_t* bitmaps = nullptr;
+    };
+  }
+}
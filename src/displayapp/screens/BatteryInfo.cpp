@@ -40,12 +40,11 @@ BatteryInfo::BatteryInfo(const Pinetime::Controllers::Battery& batteryController
   lv_label_set_align(voltage, LV_LABEL_ALIGN_CENTER);
   lv_obj_align(voltage, nullptr, LV_ALIGN_IN_BOTTOM_MID, 0, -7);
 
-  taskRefresh = lv_task_create(RefreshTaskCallback, 5000, LV_TASK_PRIO_MID, this);
+  Subscribe(Utility::TopicMask(Utility::Topic::Battery));
   Refresh();
 }
 
 BatteryInfo::~BatteryInfo() {
-  lv_task_del(taskRefresh);
   lv_obj_clean(lv_scr_act());
 }
 
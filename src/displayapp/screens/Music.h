@@ -80,7 +80,6 @@ namespace Pinetime {
 
         bool playing;
 
-        lv_task_t* taskRefresh;
 
         /** Watchapp */
       };
@@ -27,13 +27,7 @@ Notifications::Notifications(DisplayApp* app,
   auto notification = notificationManager.GetLastNotification();
   if (notification.valid) {
     currentId = notification.id;
-    currentItem = std::make_unique<NotificationItem>(notification.Title(),
-                                                     notification.Message(),
-                                                     1,
-                                                     notification.category,
-                                                     notificationManager.NbNotifications(),
-                                                     alertNotificationService,
-                                                     motorController);
+    ShowNotification(notification, 1);
     validDisplay = true;
   } else {
     currentItem = std::make_unique<NotificationItem>(alertNotificationService, motorController);
@@ -103,13 +97,7 @@ void Notifications::Refresh() {
 
     if (validDisplay) {
       Controllers::NotificationManager::Notification::Idx currentIdx = notificationManager.IndexOf(currentId);
-      currentItem = std::make_unique<NotificationItem>(notification.Title(),
-                                                       notification.Message(),
-                                                       currentIdx + 1,
-                                                       notification.category,
-                                                       notificationManager.NbNotifications(),
-                                                       alertNotificationService,
-                                                       motorController);
+      ShowNotification(notification, currentIdx + 1);
     } else {
       running = false;
     }
@@ -118,6 +106,18 @@ void Notifications::Refresh() {
   running = running && currentItem->IsRunning();
 }
 
+void Notifications::ShowNotification(const Controllers::NotificationManager::Notification& notification, uint8_t notifNr) {
+  // The labels copy the text, so a single buffer is enough for the item being created
+  size_t size = notificationManager.CopyMessage(notification.id, messageBuffer.data(), messageBuffer.size());
+  currentItem = std::make_unique<NotificationItem>(Controllers::NotificationManager::Title(messageBuffer.data(), size),
+                                                   Controllers::NotificationManager::Message(messageBuffer.data(), size),
+                                                   notifNr,
+                                                   notification.category,
+                                                   notificationManager.NbNotifications(),
+                                                   alertNotificationService,
+                                                   motorController);
+}
+
 void Notifications::OnPreviewInteraction() {
   wakeLock.Release();
   motorController.StopRinging();
@@ -196,13 +196,7 @@ bool Notifications::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
       validDisplay = true;
       currentItem.reset(nullptr);
       app->SetFullRefresh(DisplayApp::FullRefreshDirections::Down);
-      currentItem = std::make_unique<NotificationItem>(previousNotification.Title(),
-                                                       previousNotification.Message(),
-                                                       currentIdx + 1,
-                                                       previousNotification.category,
-                                                       notificationManager.NbNotifications(),
-                                                       alertNotificationService,
-                                                       motorController);
+      ShowNotification(previousNotification, currentIdx + 1);
     }
       return true;
     case Pinetime::Applications::TouchEvents::SwipeUp: {
@@ -223,13 +217,7 @@ bool Notifications::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
       validDisplay = true;
       currentItem.reset(nullptr);
       app->SetFullRefresh(DisplayApp::FullRefreshDirections::Up);
-      currentItem = std::make_unique<NotificationItem>(nextNotification.Title(),
-                                                       nextNotification.Message(),
-                                                       currentIdx + 1,
-                                                       nextNotification.category,
-                                                       notificationManager.NbNotifications(),
-                                                       alertNotificationService,
-                                                       motorController);
+      ShowNotification(nextNotification, currentIdx + 1);
     }
       return true;
     default:
@@ -2,6 +2,7 @@
 
 #include <lvgl/lvgl.h>
 #include <FreeRTOS.h>
+#include <array>
 #include <cstdint>
 #include <memory>
 #include "displayapp/screens/Screen.h"
@@ -70,6 +71,8 @@ namespace Pinetime {
         };
 
       private:
+        void ShowNotification(const Controllers::NotificationManager::Notification& notification, uint8_t notifNr);
+
         DisplayApp* app;
         Pinetime::Controllers::NotificationManager& notificationManager;
         Pinetime::Controllers::AlertNotificationService& alertNotificationService;
@@ -78,6 +81,8 @@ namespace Pinetime {
         Modes mode = Modes::Normal;
         std::unique_ptr<NotificationItem> currentItem;
         Pinetime::Controllers::NotificationManager::Notification::Id currentId;
+        // Text of the notification being displayed, only filled when its item is created
+        std::array<char, Controllers::NotificationManager::MessageSize> messageBuffer;
         bool validDisplay = false;
         bool afterDismissNextMessageFromAbove = false;
 
@@ -1,6 +1,18 @@
 #include "displayapp/screens/Screen.h"
+#include "displayapp/ScreenArena.h"
 using namespace Pinetime::Applications::Screens;
 
+void* Screen::operator new(size_t size) {
+  void* ptr = ScreenArena::Allocate(size);
+  return (ptr != nullptr) ? ptr : ::operator new(size);
+}
+
+void Screen::operator delete(void* ptr) {
+  if (!ScreenArena::Contains(ptr)) {
+    ::operator delete(ptr);
+  }
+}
+
 void Screen::RefreshTaskCallback(lv_task_t* task) {
   static_cast<Screen*>(task->user_data)->Refresh();
 }
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include "displayapp/TouchEvents.h"
+#include "utility/ChangeBus.h"
 #include <lvgl/lvgl.h>
 
 namespace Pinetime {
@@ -19,8 +20,19 @@ namespace Pinetime {
 
         virtual ~Screen() = default;
 
+        // Screens are allocated in the screen arena when it is open (see ScreenArena.h)
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr);
+
         static void RefreshTaskCallback(lv_task_t* task);
 
+        // Refreshes the screen if one of the changed topics is subscribed
+        void OnValuesChanged(uint32_t topics) {
+          if ((topics & subscriptions) != 0) {
+            Refresh();
+          }
+        }
+
         bool IsRunning() const {
           return running;
         }
@@ -41,7 +53,15 @@ namespace Pinetime {
         }
 
       protected:
+        // Refresh() is called when one of the topics changes, instead of polling from a refresh task
+        void Subscribe(uint32_t topics) {
+          subscriptions = topics;
+        }
+
         bool running = true;
+
+      private:
+        uint32_t subscriptions = 0;
       };
     }
   }
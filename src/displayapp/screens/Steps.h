@@ -39,7 +39,6 @@ namespace Pinetime {
 
         uint32_t stepsCount;
 
-        lv_task_t* taskRefresh;
       };
     }
 
@@ -64,6 +64,17 @@ SystemInfo::SystemInfo(Pinetime::Applications::DisplayApp* app,
               },
               [this]() -> std::unique_ptr<Screen> {
                 return CreateScreen5();
+              },
+              [this]() -> std::unique_ptr<Screen> {
+                return CreateScreen6();
+              },
+#if configGENERATE_RUN_TIME_STATS == 1
+              [this]() -> std::unique_ptr<Screen> {
+                return CreateCpuScreen();
+              },
+#endif
+              [this]() -> std::unique_ptr<Screen> {
+                return CreateScreen7();
               }},
              Screens::ScreenListModes::UpDown} {
 }
@@ -96,7 +107,7 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen1() {
                         BootloaderVersion::VersionString());
   lv_label_set_align(label, LV_LABEL_ALIGN_CENTER);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(0, 5, label);
+  return std::make_unique<Screens::Label>(0, nbScreens, label);
 }
 
 std::unique_ptr<Screen> SystemInfo::CreateScreen2() {
@@ -175,7 +186,7 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen2() {
                         touchPanel.GetFwVersion(),
                         TARGET_DEVICE_NAME);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(1, 5, label);
+  return std::make_unique<Screens::Label>(1, nbScreens, label);
 }
 
 extern int mallocFailedCount;
@@ -214,14 +225,84 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen3() {
                         mallocFailedCount,
                         stackOverflowCount);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(2, 5, label);
+  return std::make_unique<Screens::Label>(2, nbScreens, label);
+}
+
+std::unique_ptr<Screen> SystemInfo::CreateScreen4() {
+  HeapStats_t heapStats;
+  vPortGetHeapStats(&heapStats);
+  uint32_t histogram[portHEAP_HISTOGRAM_BUCKETS];
+  vPortGetHeapHistogram(histogram);
+
+  lv_obj_t* label = lv_label_create(lv_scr_act(), nullptr);
+  lv_label_set_recolor(label, true);
+  lv_label_set_text_fmt(label,
+                        "#808080 Heap blocks#\n"
+                        " #808080 Largest# %d\n"
+                        " #808080 Free# %d\n"
+                        " #808080 Allocs# %d\n"
+                        " #808080 Frees# %d\n"
+                        "#808080 Alloc sizes#\n"
+                        " #808080 16# %lu #808080 32# %lu\n"
+                        " #808080 64# %lu #808080 128# %lu\n"
+                        " #808080 256# %lu #808080 512# %lu\n"
+                        " #808080 1K# %lu #808080 >1K# %lu",
+                        heapStats.xSizeOfLargestFreeBlockInBytes,
+                        heapStats.xNumberOfFreeBlocks,
+                        heapStats.xNumberOfSuccessfulAllocations,
+                        heapStats.xNumberOfSuccessfulFrees,
+                        histogram[0],
+                        histogram[1],
+                        histogram[2],
+                        histogram[3],
+                        histogram[4],
+                        histogram[5],
+                        histogram[6],
+                        histogram[7]);
+  lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
+  return std::make_unique<Screens::Label>(3, nbScreens, label);
+}
+
+std::unique_ptr<Screen> SystemInfo::CreateScreen5() {
+  static constexpr uint8_t maxOwnerCount = 9;
+  HeapTaskStats_t heapTaskStats[maxOwnerCount];
+
+  lv_obj_t* infoHeap = lv_table_create(lv_scr_act(), nullptr);
+  lv_table_set_col_cnt(infoHeap, 3);
+  lv_table_set_row_cnt(infoHeap, maxOwnerCount + 1);
+  lv_obj_set_style_local_pad_all(infoHeap, LV_TABLE_PART_CELL1, LV_STATE_DEFAULT, 0);
+  lv_obj_set_style_local_border_color(infoHeap, LV_TABLE_PART_CELL1, LV_STATE_DEFAULT, Colors::lightGray);
+
+  lv_table_set_cell_value(infoHeap, 0, 0, "Task");
+  lv_table_set_col_width(infoHeap, 0, 70);
+  lv_table_set_cell_value(infoHeap, 0, 1, "Heap");
+  lv_table_set_col_width(infoHeap, 1, 80);
+  lv_table_set_cell_value(infoHeap, 0, 2, "Peak");
+  lv_table_set_col_width(infoHeap, 2, 80);
+
+  // The first entry holds the allocations made before the scheduler started
+  auto nb = uxPortGetHeapTaskStats(heapTaskStats, maxOwnerCount);
+  for (uint8_t i = 0; i < nb; i++) {
+    char buffer[11] = {0};
+
+    if (heapTaskStats[i].pvTask != nullptr) {
+      lv_table_set_cell_value(infoHeap, i + 1, 0, pcTaskGetName(static_cast<TaskHandle_t>(heapTaskStats[i].pvTask)));
+    } else {
+      lv_table_set_cell_value(infoHeap, i + 1, 0, "-");
+    }
+    snprintf(buffer, sizeof(buffer), "%u", heapTaskStats[i].xCurrentBytes);
+    lv_table_set_cell_value(infoHeap, i + 1, 1, buffer);
+    snprintf(buffer, sizeof(buffer), "%u", heapTaskStats[i].xPeakBytes);
+    lv_table_set_cell_value(infoHeap, i + 1, 2, buffer);
+  }
+  return std::make_unique<Screens::Label>(4, nbScreens, infoHeap);
 }
 
 bool SystemInfo::sortById(const TaskStatus_t& lhs, const TaskStatus_t& rhs) {
   return lhs.xTaskNumber < rhs.xTaskNumber;
 }
 
-std::unique_ptr<Screen> SystemInfo::CreateScreen4() {
+std::unique_ptr<Screen> SystemInfo::CreateScreen6() {
   static constexpr uint8_t maxTaskCount = 9;
   TaskStatus_t tasksStatus[maxTaskCount];
 
@@ -280,10 +361,71 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen4() {
     }
     lv_table_set_cell_value(infoTask, i + 1, 3, buffer);
   }
-  return std::make_unique<Screens::Label>(3, 5, infoTask);
+  return std::make_unique<Screens::Label>(5, nbScreens, infoTask);
 }
 
-std::unique_ptr<Screen> SystemInfo::CreateScreen5() {
+#if configGENERATE_RUN_TIME_STATS == 1
+bool SystemInfo::sortByRunTime(const TaskStatus_t& lhs, const TaskStatus_t& rhs) {
+  return lhs.ulRunTimeCounter > rhs.ulRunTimeCounter;
+}
+
+std::unique_ptr<Screen> SystemInfo::CreateCpuScreen() {
+  static constexpr uint8_t maxTaskCount = 10;
+  static constexpr uint8_t maxDisplayedTasks = 7;
+  TaskStatus_t tasksStatus[maxTaskCount];
+  RunTimeStats_t runTimeStats;
+
+  auto nb = uxTaskGetSystemState(tasksStatus, maxTaskCount, nullptr);
+  vPortGetRunTimeStats(&runTimeStats);
+  // Times are counted since boot, shown in tenths of percent
+  const uint64_t total = std::max<uint32_t>(runTimeStats.ulTotalTime, 1);
+  auto perMille = [total](uint32_t time) -> uint32_t {
+    return static_cast<uint32_t>(static_cast<uint64_t>(time) * 1000 / total);
+  };
+  uint32_t isrTime = 0;
+  for (auto time : runTimeStats.ulIsrTime) {
+    isrTime += time;
+  }
+
+  lv_obj_t* label = lv_label_create(lv_scr_act(), nullptr);
+  lv_label_set_recolor(label, true);
+  lv_label_set_text_fmt(label,
+                        "#808080 Sleep# %lu.%lu%%\n"
+                        "#808080 ISR# %lu.%lu%%",
+                        perMille(runTimeStats.ulSleepTime) / 10,
+                        perMille(runTimeStats.ulSleepTime) % 10,
+                        perMille(isrTime) / 10,
+                        perMille(isrTime) % 10);
+  lv_obj_align(label, lv_scr_act(), LV_ALIGN_IN_TOP_LEFT, 0, 0);
+
+  lv_obj_t* infoTask = lv_table_create(lv_scr_act(), nullptr);
+  lv_table_set_col_cnt(infoTask, 2);
+  lv_table_set_row_cnt(infoTask, maxDisplayedTasks + 1);
+  lv_obj_set_style_local_pad_all(infoTask, LV_TABLE_PART_CELL1, LV_STATE_DEFAULT, 0);
+  lv_obj_set_style_local_border_color(infoTask, LV_TABLE_PART_CELL1, LV_STATE_DEFAULT, Colors::lightGray);
+
+  lv_table_set_cell_value(infoTask, 0, 0, "Task");
+  lv_table_set_col_width(infoTask, 0, 120);
+  lv_table_set_cell_value(infoTask, 0, 1, "CPU");
+  lv_table_set_col_width(infoTask, 1, 110);
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Warray-bounds"
+  std::sort(tasksStatus, tasksStatus + nb, sortByRunTime);
+#pragma GCC diagnostic pop
+  for (uint8_t i = 0; i < nb && i < maxDisplayedTasks; i++) {
+    char buffer[12] = {0};
+    lv_table_set_cell_value(infoTask, i + 1, 0, tasksStatus[i].pcTaskName);
+    auto taskPerMille = perMille(tasksStatus[i].ulRunTimeCounter);
+    snprintf(buffer, sizeof(buffer), "%lu.%lu%%", taskPerMille / 10, taskPerMille % 10);
+    lv_table_set_cell_value(infoTask, i + 1, 1, buffer);
+  }
+  lv_obj_align(infoTask, label, LV_ALIGN_OUT_BOTTOM_LEFT, 0, 5);
+  return std::make_unique<Screens::Label>(6, nbScreens, infoTask);
+}
+#endif
+
+std::unique_ptr<Screen> SystemInfo::CreateScreen7() {
   lv_obj_t* label = lv_label_create(lv_scr_act(), nullptr);
   lv_label_set_recolor(label, true);
   lv_label_set_text_static(label,
@@ -297,5 +439,5 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen5() {
                            "#FFFF00 InfiniTime#");
   lv_label_set_align(label, LV_LABEL_ALIGN_CENTER);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(4, 5, label);
+  return std::make_unique<Screens::Label>(nbScreens - 1, nbScreens, label);
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <FreeRTOS.h>
 #include <memory>
 #include "displayapp/screens/Screen.h"
 #include "displayapp/screens/ScreenList.h"
@@ -44,15 +45,21 @@ namespace Pinetime {
         const Pinetime::Drivers::Cst816S& touchPanel;
         const Pinetime::Drivers::SpiNorFlash& spiNorFlash;
 
-        ScreenList<5> screens;
+        // The CPU usage screen is only available when run-time statistics are enabled
+        static constexpr uint8_t nbScreens = (configGENERATE_RUN_TIME_STATS == 1) ? 8 : 7;
+        ScreenList<nbScreens> screens;
 
         static bool sortById(const TaskStatus_t& lhs, const TaskStatus_t& rhs);
+        static bool sortByRunTime(const TaskStatus_t& lhs, const TaskStatus_t& rhs);
 
         std::unique_ptr<Screen> CreateScreen1();
         std::unique_ptr<Screen> CreateScreen2();
         std::unique_ptr<Screen> CreateScreen3();
         std::unique_ptr<Screen> CreateScreen4();
         std::unique_ptr<Screen> CreateScreen5();
+        std::unique_ptr<Screen> CreateScreen6();
+        std::unique_ptr<Screen> CreateScreen7();
+        std::unique_ptr<Screen> CreateCpuScreen();
       };
     }
   }
@@ -141,8 +141,14 @@ WatchFaceFennec::WatchFaceFennec(Controllers::DateTime& dateTimeController,
   lv_label_set_text_static(notificationIcon, NotificationIcon::GetIcon(false));
   lv_obj_align(notificationIcon, bleIcon, LV_ALIGN_OUT_LEFT_MID, -5, 0);
 
-  // Set a task that will periodically refresh the screen
-  taskRefresh = lv_task_create(RefreshTaskCallback, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_MID, this);
+  // Refresh the screen when one of the displayed values changes
+  Subscribe(Utility::TopicMask(Utility::Topic::Time,
+                               Utility::Topic::Battery,
+                               Utility::Topic::Ble,
+                               Utility::Topic::Notifications,
+                               Utility::Topic::HeartRate,
+                               Utility::Topic::Steps,
+                               Utility::Topic::Weather));
 
   // Default mode
   mode = WatchFaceFennec::Mode::Day;
@@ -153,7 +159,6 @@ WatchFaceFennec::WatchFaceFennec(Controllers::DateTime& dateTimeController,
 
 // Destructor
 WatchFaceFennec::~WatchFaceFennec() {
-  lv_task_del(taskRefresh);
   lv_obj_clean(lv_scr_act());
 }
 
@@ -124,7 +124,6 @@ namespace Pinetime {
         const Controllers::Battery& batteryController;
         const Controllers::Ble& bleController;
 
-        lv_task_t* taskRefresh;
       };
     }
 
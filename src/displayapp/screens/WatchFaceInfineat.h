@@ -6,6 +6,7 @@
 #include <memory>
 #include <displayapp/Controllers.h>
 #include "displayapp/screens/Screen.h"
+#include "displayapp/StreamedFont.h"
 #include "components/datetime/DateTimeController.h"
 #include "utility/DirtyValue.h"
 #include "displayapp/apps/Apps.h"
@@ -96,6 +97,8 @@ namespace Pinetime {
         void ToggleBatteryIndicatorColor(bool showSideCover);
 
         lv_task_t* taskRefresh;
+        Components::StreamedFont fontTeko;
+        Components::StreamedFont fontBebas;
         lv_font_t* font_teko = nullptr;
         lv_font_t* font_bebas = nullptr;
       };
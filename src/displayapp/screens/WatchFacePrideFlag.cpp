@@ -163,12 +163,15 @@ WatchFacePrideFlag::WatchFacePrideFlag(Controllers::DateTime& dateTimeController
 
   UpdateScreen(settingsController.GetPrideFlag());
 
-  taskRefresh = lv_task_create(RefreshTaskCallback, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_MID, this);
+  Subscribe(Utility::TopicMask(Utility::Topic::Time,
+                               Utility::Topic::Battery,
+                               Utility::Topic::Ble,
+                               Utility::Topic::Notifications,
+                               Utility::Topic::Steps));
   Refresh();
 }
 
 WatchFacePrideFlag::~WatchFacePrideFlag() {
-  lv_task_del(taskRefresh);
   lv_obj_clean(lv_scr_act());
 }
 
@@ -282,6 +285,7 @@ void WatchFacePrideFlag::UpdateSelected(lv_obj_t* object, lv_event_t event) {
     settingsController.SetPrideFlag(valueFlag);
     if (flagChanged) {
       UpdateScreen(valueFlag);
+      Refresh();
     }
   }
 }
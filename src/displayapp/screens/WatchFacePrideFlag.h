@@ -75,7 +75,6 @@ namespace Pinetime {
         Controllers::Settings& settingsController;
         Controllers::MotionController& motionController;
 
-        lv_task_t* taskRefresh;
         void CloseMenu();
       };
     }
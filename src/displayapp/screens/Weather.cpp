@@ -104,12 +104,11 @@ Weather::Weather(Controllers::Settings& settingsController, Controllers::SimpleW
     lv_table_set_cell_align(forecast, 3, i, LV_LABEL_ALIGN_CENTER);
   }
 
-  taskRefresh = lv_task_create(RefreshTaskCallback, 1000, LV_TASK_PRIO_MID, this);
+  Subscribe(Utility::TopicMask(Utility::Topic::Weather));
   Refresh();
 }
 
 Weather::~Weather() {
-  lv_task_del(taskRefresh);
   lv_obj_clean(lv_scr_act());
 }
 
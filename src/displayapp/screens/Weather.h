@@ -39,7 +39,6 @@ namespace Pinetime {
         lv_obj_t* maxTemperature;
         lv_obj_t* forecast;
 
-        lv_task_t* taskRefresh;
       };
     }
 
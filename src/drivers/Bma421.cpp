@@ -32,6 +32,12 @@ namespace {
     [BMA4_ACCEL_RANGE_8G] = 256,  // LSB/g +/- 8g range
     [BMA4_ACCEL_RANGE_16G] = 128  // LSB/g +/- 16g range
   };
+
+  // The FIFO is fed with the filtered data, downsampled by 2^3: 12.5Hz at 100Hz ODR. This is close to
+  // the rate at which SystemTask used to poll the sensor, which the motion detection thresholds are tuned for.
+  constexpr uint8_t fifoDownsampling = 3;
+  static_assert(Pinetime::Drivers::Bma421::fifoSamplePeriod == (1000 << fifoDownsampling) / 100);
+  constexpr uint8_t fifoFlushCommand = 0xB0;
 }
 
 Bma421::Bma421(TwiMaster& twiMaster, uint8_t twiAddress) : twiMaster {twiMaster}, deviceAddress {twiAddress} {
@@ -93,6 +99,13 @@ void Bma421::Init() {
     return;
 
   isOk = true;
+
+  // Headerless FIFO with accelerometer frames only. If it can't be configured, Process() falls back to
+  // reading the data registers.
+  fifoEnabled = bma4_set_fifo_config(BMA4_FIFO_HEADER, BMA4_DISABLE, &bma) == BMA4_OK &&
+                bma4_set_fifo_down_accel(fifoDownsampling, &bma) == BMA4_OK &&
+                bma4_set_accel_fifo_filter_data(BMA4_ENABLE, &bma) == BMA4_OK &&
+                bma4_set_fifo_config(BMA4_FIFO_ACCEL, BMA4_ENABLE, &bma) == BMA4_OK;
 }
 
 void Bma421::Reset() {
@@ -111,23 +124,63 @@ void Bma421::Write(uint8_t registerAddress, const uint8_t* data, size_t size) {
 Bma421::Values Bma421::Process() {
   if (not isOk)
     return {};
-  struct bma4_accel rawData;
-  struct bma4_accel data;
-  bma4_read_accel_xyz(&rawData, &bma);
+  Values values {};
+
+  uint16_t fifoLength = 0;
+  if (fifoEnabled) {
+    bma4_get_fifo_length(&fifoLength, &bma);
+  }
+  size_t nbFrames = fifoLength / BMA4_FIFO_A_LENGTH;
+  if (nbFrames > 0 && nbFrames <= maxFifoSamples) {
+    // Drain all the frames in a single burst read
+    uint8_t buffer[maxFifoSamples * BMA4_FIFO_A_LENGTH];
+    Read(BMA4_FIFO_DATA_ADDR, buffer, nbFrames * BMA4_FIFO_A_LENGTH);
+    for (size_t i = 0; i < nbFrames; i++) {
+      const uint8_t* frame = &buffer[i * BMA4_FIFO_A_LENGTH];
+      struct bma4_accel rawData;
+      rawData.x = static_cast<int16_t>((frame[1] << 8) | frame[0]);
+      rawData.y = static_cast<int16_t>((frame[3] << 8) | frame[2]);
+      rawData.z = static_cast<int16_t>((frame[5] << 8) | frame[4]);
+      if (bma.resolution == BMA4_12_BIT_RESOLUTION) {
+        rawData.x /= 0x10;
+        rawData.y /= 0x10;
+        rawData.z /= 0x10;
+      } else if (bma.resolution == BMA4_14_BIT_RESOLUTION) {
+        rawData.x /= 0x04;
+        rawData.y /= 0x04;
+        rawData.z /= 0x04;
+      }
+      values.samples[i] = Convert(rawData);
+    }
+    values.nbSamples = nbFrames;
+    values.samplePeriod = fifoSamplePeriod;
+  } else if (not fifoEnabled || nbFrames > maxFifoSamples) {
+    // The FIFO was not drained for a while (motion updates are disabled in sleep mode): drop the old
+    // samples and only report the current one.
+    if (fifoEnabled) {
+      bma4_set_command_register(fifoFlushCommand, &bma);
+    }
+    struct bma4_accel rawData;
+    bma4_read_accel_xyz(&rawData, &bma);
+    values.samples[0] = Convert(rawData);
+    values.nbSamples = 1;
+  }
+
+  bma423_step_counter_output(&values.steps, &bma);
+  return values;
+}
 
+Bma421::Sample Bma421::Convert(const bma4_accel& rawData) const {
   // Scale the measured ADC counts to units of 'binary milli-g'
   // where 1g = 1024 'binary milli-g' units.
   // See https://github.com/InfiniTimeOrg/InfiniTime/pull/1950 for
   // discussion of why we opted for scaling to 1024 rather than 1000.
-  data.x = 1024 * rawData.x / accelScaleFactors[accel_conf.range];
-  data.y = 1024 * rawData.y / accelScaleFactors[accel_conf.range];
-  data.z = 1024 * rawData.z / accelScaleFactors[accel_conf.range];
-
-  uint32_t steps = 0;
-  bma423_step_counter_output(&steps, &bma);
+  auto x = static_cast<int16_t>(1024 * rawData.x / accelScaleFactors[accel_conf.range]);
+  auto y = static_cast<int16_t>(1024 * rawData.y / accelScaleFactors[accel_conf.range]);
+  auto z = static_cast<int16_t>(1024 * rawData.z / accelScaleFactors[accel_conf.range]);
 
   // X and Y axis are swapped because of the way the sensor is mounted in the PineTime
-  return {steps, data.y, data.x, data.z};
+  return {y, x, z};
 }
 
 bool Bma421::IsOk() const {
@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include <drivers/Bma421_C/bma4_defs.h>
 
 namespace Pinetime {
@@ -9,13 +10,28 @@ namespace Pinetime {
     public:
       enum class DeviceTypes : uint8_t { Unknown, BMA421, BMA425 };
 
-      struct Values {
-        uint32_t steps;
+      struct Sample {
         int16_t x;
         int16_t y;
         int16_t z;
       };
 
+      // Maximum number of samples drained from the FIFO by Process(). The burst read (6 bytes per sample)
+      // must complete within the hardware freeze timeout of TwiMaster. Older samples are dropped, so Process() must
+      // be called at least every maxFifoSamples * fifoSamplePeriod milliseconds.
+      static constexpr size_t maxFifoSamples = 16;
+      // Time between two consecutive samples drained from the FIFO, in milliseconds (12.5Hz)
+      static constexpr uint32_t fifoSamplePeriod = 80;
+
+      struct Values {
+        uint32_t steps;
+        // Samples accumulated in the FIFO since the previous call, oldest first
+        size_t nbSamples;
+        // Time between the samples in milliseconds, 0 if the single sample was read from the data registers
+        uint32_t samplePeriod;
+        std::array<Sample, maxFifoSamples> samples;
+      };
+
       Bma421(TwiMaster& twiMaster, uint8_t twiAddress);
       Bma421(const Bma421&) = delete;
       Bma421& operator=(const Bma421&) = delete;
@@ -33,16 +49,22 @@ namespace Pinetime {
       void Write(uint8_t registerAddress, const uint8_t* data, size_t size);
 
       bool IsOk() const;
+      // The samples are buffered in the FIFO, Process() can be called much less often than the sampling rate
+      bool IsFifoEnabled() const {
+        return fifoEnabled;
+      }
       DeviceTypes DeviceType() const;
 
     private:
       void Reset();
+      Sample Convert(const bma4_accel& rawData) const;
 
       TwiMaster& twiMaster;
       uint8_t deviceAddress = 0x18;
       struct bma4_dev bma;
       struct bma4_accel_config accel_conf; // Store the device configuration for later reference.
       bool isOk = false;
+      bool fifoEnabled = false;
       bool isResetOk = false;
       DeviceTypes deviceType = DeviceTypes::Unknown;
     };
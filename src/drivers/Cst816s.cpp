@@ -113,15 +113,13 @@ void Cst816S::Wakeup() {
 
 bool Cst816S::CheckDeviceIds() {
   // There's mixed information about which register contains which information
-  if (twiMaster.Read(twiAddress, 0xA7, &chipId, 1) == TwiMaster::ErrorCodes::TransactionFailed) {
+  TwiMaster::Transaction reads[3];
+  reads[0] = {twiAddress, 0xA7, nullptr, 0, &chipId, 1};
+  reads[1] = {twiAddress, 0xA8, nullptr, 0, &vendorId, 1};
+  reads[2] = {twiAddress, 0xA9, nullptr, 0, &fwVersion, 1};
+  if (twiMaster.Transfer(reads, 3) == TwiMaster::ErrorCodes::TransactionFailed) {
     chipId = 0xFF;
-    return false;
-  }
-  if (twiMaster.Read(twiAddress, 0xA8, &vendorId, 1) == TwiMaster::ErrorCodes::TransactionFailed) {
     vendorId = 0xFF;
-    return false;
-  }
-  if (twiMaster.Read(twiAddress, 0xA9, &fwVersion, 1) == TwiMaster::ErrorCodes::TransactionFailed) {
     fwVersion = 0xFF;
     return false;
   }
@@ -34,20 +34,29 @@ void Hrs3300::Init() {
   vTaskDelay(100);
 
   // HRS disabled, 50ms wait time between ADC conversion period, current 12.5mA
-  WriteRegister(static_cast<uint8_t>(Registers::Enable), 0x50);
+  static constexpr uint8_t enable = 0x50;
 
   // Current 12.5mA and low nibble 0xF.
   // Note: Setting low nibble to 0x8 per the datasheet results in
   // modulated LED driver output. Setting to 0xF results in clean,
   // steady output during the ADC conversion period.
-  WriteRegister(static_cast<uint8_t>(Registers::PDriver), ledDriveCurrentValue);
+  static constexpr uint8_t pDriver = ledDriveCurrentValue;
 
   // HRS and ALS both in 15-bit mode results in ~50ms LED drive period
   // and presumably ~50ms ADC conversion period.
-  WriteRegister(static_cast<uint8_t>(Registers::Res), 0x77);
+  static constexpr uint8_t res = 0x77;
 
   // Gain set to 1x
-  WriteRegister(static_cast<uint8_t>(Registers::Hgain), 0x00);
+  static constexpr uint8_t hGain = 0x00;
+
+  TwiMaster::Transaction writes[4];
+  writes[0] = {twiAddress, static_cast<uint8_t>(Registers::Enable), &enable, 1};
+  writes[1] = {twiAddress, static_cast<uint8_t>(Registers::PDriver), &pDriver, 1};
+  writes[2] = {twiAddress, static_cast<uint8_t>(Registers::Res), &res, 1};
+  writes[3] = {twiAddress, static_cast<uint8_t>(Registers::Hgain), &hGain, 1};
+  if (twiMaster.Transfer(writes, 4) != TwiMaster::ErrorCodes::NoError) {
+    NRF_LOG_INFO("WRITE ERROR");
+  }
 }
 
 void Hrs3300::Enable() {
@@ -26,6 +26,35 @@ bool Spi::WriteCmdAndBuffer(const uint8_t* cmd, size_t cmdSize, const uint8_t* d
   return spiMaster.WriteCmdAndBuffer(pinCsn, cmd, cmdSize, data, dataSize);
 }
 
+bool Spi::Transfer(SpiMaster::Transaction transaction) {
+  transaction.pinCsn = pinCsn;
+  return spiMaster.Transfer(std::move(transaction));
+}
+
+bool Spi::Enqueue(SpiMaster::Transaction transaction) {
+  transaction.pinCsn = pinCsn;
+  return spiMaster.Enqueue(std::move(transaction));
+}
+
+bool Spi::WriteAsync(const uint8_t* data,
+                     size_t size,
+                     const std::function<void()>& preTransactionHook,
+                     std::function<void()> onCompleted) {
+  return spiMaster.WriteAsync(pinCsn, data, size, preTransactionHook, std::move(onCompleted));
+}
+
+bool Spi::ReadAsync(const uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize, std::function<void()> onCompleted) {
+  return spiMaster.ReadAsync(pinCsn, cmd, cmdSize, data, dataSize, std::move(onCompleted));
+}
+
+bool Spi::WriteCmdAndBufferAsync(const uint8_t* cmd,
+                                 size_t cmdSize,
+                                 const uint8_t* data,
+                                 size_t dataSize,
+                                 std::function<void()> onCompleted) {
+  return spiMaster.WriteCmdAndBufferAsync(pinCsn, cmd, cmdSize, data, dataSize, std::move(onCompleted));
+}
+
 bool Spi::Init() {
   nrf_gpio_cfg_output(pinCsn);
   nrf_gpio_pin_set(pinCsn);
@@ -18,6 +18,22 @@ namespace Pinetime {
       bool Write(const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook);
       bool Read(uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize);
       bool WriteCmdAndBuffer(const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize);
+
+      // The CS pin of the transaction is set to the one of this device
+      bool Transfer(SpiMaster::Transaction transaction);
+      bool Enqueue(SpiMaster::Transaction transaction);
+
+      // Non-blocking variants, see SpiMaster::Enqueue()
+      bool WriteAsync(const uint8_t* data,
+                      size_t size,
+                      const std::function<void()>& preTransactionHook,
+                      std::function<void()> onCompleted = nullptr);
+      bool ReadAsync(const uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize, std::function<void()> onCompleted);
+      bool WriteCmdAndBufferAsync(const uint8_t* cmd,
+                                  size_t cmdSize,
+                                  const uint8_t* data,
+                                  size_t dataSize,
+                                  std::function<void()> onCompleted = nullptr);
       void Sleep();
       void Wakeup();
 
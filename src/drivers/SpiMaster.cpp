@@ -6,13 +6,39 @@
 
 using namespace Pinetime::Drivers;
 
+namespace {
+  // Size of the chunks of a chained transfer, or 0 if the buffer can't be chained. All the chunks of the chain have
+  // the same size, so it must divide the buffer evenly (ex: 240 bytes for full-width display lines) into at least
+  // 2 chunks. Other buffers are sent chunk by chunk from the END interrupt.
+  constexpr size_t ChainedChunkSize(size_t size, size_t maxChunkSize) {
+    for (size_t chunkSize = maxChunkSize; chunkSize > maxChunkSize / 2; chunkSize--) {
+      if ((size % chunkSize) == 0 && size / chunkSize >= 2) {
+        return chunkSize;
+      }
+    }
+    return 0;
+  }
+
+  static_assert(ChainedChunkSize(255, 255) == 0);
+  static_assert(ChainedChunkSize(256, 255) == 128);
+  static_assert(ChainedChunkSize(257, 255) == 0);
+  static_assert(ChainedChunkSize(300, 255) == 150);
+  static_assert(ChainedChunkSize(509, 255) == 0);
+  static_assert(ChainedChunkSize(510, 255) == 255);
+  static_assert(ChainedChunkSize(240 * 2 * 4, 255) == 240);
+}
+
 SpiMaster::SpiMaster(const SpiMaster::SpiModule spi, const SpiMaster::Parameters& params) : spi {spi}, params {params} {
 }
 
 bool SpiMaster::Init() {
-  if (mutex == nullptr) {
-    mutex = xSemaphoreCreateBinary();
-    ASSERT(mutex != nullptr);
+  if (freeSlots == nullptr) {
+    freeSlots = xSemaphoreCreateCounting(queueSize, queueSize);
+    ASSERT(freeSlots != nullptr);
+    syncMutex = xSemaphoreCreateMutex();
+    ASSERT(syncMutex != nullptr);
+    syncDone = xSemaphoreCreateBinary();
+    ASSERT(syncDone != nullptr);
   }
 
   /* Configure GPIO pins used for pselsck, pselmosi, pselmiso and pselss for SPI0 */
@@ -90,7 +116,22 @@ bool SpiMaster::Init() {
   NRFX_IRQ_PRIORITY_SET(SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQn, 2);
   NRFX_IRQ_ENABLE(SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQn);
 
-  xSemaphoreGive(mutex);
+  /* Chained transfers: END -> TIMER COUNT, END -> START (until COMPARE0 disables the group), COMPARE1 -> IRQ */
+  const uint32_t endEvent = nrf_spim_event_address_get(spiBaseAddress, NRF_SPIM_EVENT_END);
+  nrf_timer_task_trigger(chainTimer, NRF_TIMER_TASK_STOP);
+  nrf_timer_mode_set(chainTimer, NRF_TIMER_MODE_LOW_POWER_COUNTER);
+  nrf_timer_bit_width_set(chainTimer, NRF_TIMER_BIT_WIDTH_16);
+  nrf_timer_int_enable(chainTimer, NRF_TIMER_INT_COMPARE1_MASK);
+  nrf_ppi_channel_endpoint_setup(chainCountPpi, endEvent, (uint32_t) nrf_timer_task_address_get(chainTimer, NRF_TIMER_TASK_COUNT));
+  nrf_ppi_channel_endpoint_setup(chainRestartPpi, endEvent, nrf_spim_task_address_get(spiBaseAddress, NRF_SPIM_TASK_START));
+  nrf_ppi_channel_endpoint_setup(chainStopPpi,
+                                 (uint32_t) nrf_timer_event_address_get(chainTimer, NRF_TIMER_EVENT_COMPARE0),
+                                 (uint32_t) nrf_ppi_task_group_disable_address_get(chainPpiGroup));
+  nrf_ppi_channel_include_in_group(chainRestartPpi, chainPpiGroup);
+
+  NRFX_IRQ_PRIORITY_SET(TIMER1_IRQn, 2);
+  NRFX_IRQ_ENABLE(TIMER1_IRQn);
+
   return true;
 }
 
@@ -136,25 +177,26 @@ void SpiMaster::DisableWorkaroundForErratum58() {
 }
 
 void SpiMaster::OnEndEvent() {
-  if (currentBufferAddr == 0) {
+  if (!busy) {
     return;
   }
 
-  auto s = currentBufferSize;
-  if (s > 0) {
-    auto currentSize = std::min((size_t) 255, s);
-    PrepareTx(currentBufferAddr, currentSize);
-    currentBufferAddr = currentBufferAddr + currentSize;
-    currentBufferSize = currentBufferSize - currentSize;
+  if (currentBufferSize > 0) {
+    ContinueBuffer();
+  } else if (!StartNextPhase()) {
+    CompleteTransaction();
+    StartNextTransaction();
+  }
+}
 
-    spiBaseAddress->TASKS_START = 1;
-  } else {
-    nrf_gpio_pin_set(this->pinCsn);
-    currentBufferAddr = 0;
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    xSemaphoreGiveFromISR(mutex, &xHigherPriorityTaskWoken);
-    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+void SpiMaster::OnChainedTransferEndEvent() {
+  if (!chainActive) {
+    return;
   }
+
+  StopChainedTransfer();
+  // The whole buffer was sent, move on to the next phase
+  OnEndEvent();
 }
 
 void SpiMaster::OnStartedEvent() {
@@ -170,6 +212,46 @@ void SpiMaster::PrepareTx(const uint32_t bufferAddress, const size_t size) {
   spiBaseAddress->EVENTS_END = 0;
 }
 
+void SpiMaster::StartChainedTransfer(size_t chunkSize) {
+  const size_t nbChunks = currentBufferSize / chunkSize;
+
+  PrepareTx(currentBufferAddr, chunkSize);
+  spiBaseAddress->TXD.LIST = SPIM_TXD_LIST_LIST_ArrayList << SPIM_TXD_LIST_LIST_Pos;
+  currentBufferAddr = currentBufferAddr + currentBufferSize;
+  currentBufferSize = 0;
+
+  // The end of the chain is signaled by the timer instead of the END/STARTED events of each chunk
+  spiBaseAddress->INTENCLR = (1 << 6);
+  spiBaseAddress->INTENCLR = (1 << 19);
+
+  nrf_timer_task_trigger(chainTimer, NRF_TIMER_TASK_CLEAR);
+  nrf_timer_cc_write(chainTimer, NRF_TIMER_CC_CHANNEL0, nbChunks - 1);
+  nrf_timer_cc_write(chainTimer, NRF_TIMER_CC_CHANNEL1, nbChunks);
+  nrf_timer_event_clear(chainTimer, NRF_TIMER_EVENT_COMPARE0);
+  nrf_timer_event_clear(chainTimer, NRF_TIMER_EVENT_COMPARE1);
+  nrf_timer_task_trigger(chainTimer, NRF_TIMER_TASK_START);
+
+  nrf_ppi_channel_enable(chainCountPpi);
+  nrf_ppi_channel_enable(chainStopPpi);
+  nrf_ppi_group_enable(chainPpiGroup);
+  chainActive = true;
+
+  spiBaseAddress->TASKS_START = 1;
+}
+
+void SpiMaster::StopChainedTransfer() {
+  nrf_ppi_group_disable(chainPpiGroup);
+  nrf_ppi_channel_disable(chainStopPpi);
+  nrf_ppi_channel_disable(chainCountPpi);
+  nrf_timer_task_trigger(chainTimer, NRF_TIMER_TASK_STOP);
+  chainActive = false;
+
+  spiBaseAddress->EVENTS_END = 0;
+  spiBaseAddress->EVENTS_STARTED = 0;
+  spiBaseAddress->INTENSET = (1 << 6);
+  spiBaseAddress->INTENSET = (1 << 19);
+}
+
 void SpiMaster::PrepareRx(const uint32_t bufferAddress, const size_t size) {
   spiBaseAddress->TXD.PTR = 0;
   spiBaseAddress->TXD.MAXCNT = 0;
@@ -180,77 +262,237 @@ void SpiMaster::PrepareRx(const uint32_t bufferAddress, const size_t size) {
   spiBaseAddress->EVENTS_END = 0;
 }
 
+bool SpiMaster::Enqueue(Transaction transaction) {
+  if (transaction.txSize > 0 && transaction.txData == nullptr) {
+    return false;
+  }
+  if (transaction.rxSize > 0 && transaction.rxData == nullptr) {
+    return false;
+  }
+
+  xSemaphoreTake(freeSlots, portMAX_DELAY);
+
+  taskENTER_CRITICAL();
+  queue[(queueHead + queueCount) % queueSize] = std::move(transaction);
+  queueCount++;
+  if (!busy) {
+    busy = true;
+    StartNextTransaction();
+  }
+  taskEXIT_CRITICAL();
+
+  return true;
+}
+
+bool SpiMaster::Transfer(Transaction transaction) {
+  xSemaphoreTake(syncMutex, portMAX_DELAY);
+
+  transaction.onCompleted = [this]() {
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    xSemaphoreGiveFromISR(syncDone, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+  };
+  bool ok = Enqueue(std::move(transaction));
+  if (ok) {
+    xSemaphoreTake(syncDone, portMAX_DELAY);
+  }
+
+  xSemaphoreGive(syncMutex);
+  return ok;
+}
+
+bool SpiMaster::MakeTransaction(Transaction& transaction,
+                                uint8_t pinCsn,
+                                const uint8_t* cmd,
+                                size_t cmdSize,
+                                const uint8_t* txData,
+                                size_t txSize,
+                                uint8_t* rxData,
+                                size_t rxSize) {
+  if (cmdSize > transaction.command.size()) {
+    return false;
+  }
+
+  transaction.pinCsn = pinCsn;
+  std::copy_n(cmd, cmdSize, transaction.command.begin());
+  transaction.commandSize = cmdSize;
+  transaction.txData = txData;
+  transaction.txSize = txSize;
+  transaction.rxData = rxData;
+  transaction.rxSize = rxSize;
+  return true;
+}
+
 bool SpiMaster::Write(uint8_t pinCsn, const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook) {
-  if (data == nullptr)
+  Transaction transaction;
+  MakeTransaction(transaction, pinCsn, nullptr, 0, data, size, nullptr, 0);
+  transaction.preTransactionHook = preTransactionHook;
+  return Transfer(std::move(transaction));
+}
+
+bool SpiMaster::Read(uint8_t pinCsn, uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize) {
+  Transaction transaction;
+  if (!MakeTransaction(transaction, pinCsn, cmd, cmdSize, nullptr, 0, data, dataSize)) {
     return false;
-  auto ok = xSemaphoreTake(mutex, portMAX_DELAY);
-  ASSERT(ok == true);
+  }
+  return Transfer(std::move(transaction));
+}
 
-  this->pinCsn = pinCsn;
+bool SpiMaster::WriteCmdAndBuffer(uint8_t pinCsn, const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize) {
+  Transaction transaction;
+  if (!MakeTransaction(transaction, pinCsn, cmd, cmdSize, data, dataSize, nullptr, 0)) {
+    return false;
+  }
+  return Transfer(std::move(transaction));
+}
 
-  if (size == 1) {
+bool SpiMaster::WriteAsync(uint8_t pinCsn,
+                           const uint8_t* data,
+                           size_t size,
+                           const std::function<void()>& preTransactionHook,
+                           std::function<void()> onCompleted) {
+  Transaction transaction;
+  MakeTransaction(transaction, pinCsn, nullptr, 0, data, size, nullptr, 0);
+  transaction.preTransactionHook = preTransactionHook;
+  transaction.onCompleted = std::move(onCompleted);
+  return Enqueue(std::move(transaction));
+}
+
+bool SpiMaster::ReadAsync(uint8_t pinCsn,
+                          const uint8_t* cmd,
+                          size_t cmdSize,
+                          uint8_t* data,
+                          size_t dataSize,
+                          std::function<void()> onCompleted) {
+  Transaction transaction;
+  if (!MakeTransaction(transaction, pinCsn, cmd, cmdSize, nullptr, 0, data, dataSize)) {
+    return false;
+  }
+  transaction.onCompleted = std::move(onCompleted);
+  return Enqueue(std::move(transaction));
+}
+
+bool SpiMaster::WriteCmdAndBufferAsync(uint8_t pinCsn,
+                                       const uint8_t* cmd,
+                                       size_t cmdSize,
+                                       const uint8_t* data,
+                                       size_t dataSize,
+                                       std::function<void()> onCompleted) {
+  Transaction transaction;
+  if (!MakeTransaction(transaction, pinCsn, cmd, cmdSize, data, dataSize, nullptr, 0)) {
+    return false;
+  }
+  transaction.onCompleted = std::move(onCompleted);
+  return Enqueue(std::move(transaction));
+}
+
+// Starts the transactions at the head of the queue until one of them is in progress on the bus.
+// Must be called with the interrupts masked (critical section or SPI interrupt).
+void SpiMaster::StartNextTransaction() {
+  while (queueCount > 0) {
+    if (StartTransaction()) {
+      return;
+    }
+    CompleteTransaction();
+  }
+  busy = false;
+}
+
+// Returns false if the transaction is already done (nothing to send or Erratum 58 path)
+bool SpiMaster::StartTransaction() {
+  auto& transaction = queue[queueHead];
+  this->pinCsn = transaction.pinCsn;
+
+  const bool singleByteWrite = transaction.commandSize == 0 && transaction.txSize == 1 && transaction.rxSize == 0;
+  if (singleByteWrite) {
     SetupWorkaroundForErratum58();
   } else {
     DisableWorkaroundForErratum58();
   }
 
-  if (preTransactionHook != nullptr) {
-    preTransactionHook();
+  if (transaction.preTransactionHook != nullptr) {
+    transaction.preTransactionHook();
   }
   nrf_gpio_pin_clear(this->pinCsn);
 
-  currentBufferAddr = (uint32_t) data;
-  currentBufferSize = size;
-
-  auto currentSize = std::min((size_t) 255, (size_t) currentBufferSize);
-  PrepareTx(currentBufferAddr, currentSize);
-  currentBufferSize = currentBufferSize - currentSize;
-  currentBufferAddr = currentBufferAddr + currentSize;
-  spiBaseAddress->TASKS_START = 1;
-
-  if (size == 1) {
+  if (singleByteWrite) {
+    PrepareTx((uint32_t) transaction.txData, 1);
+    spiBaseAddress->TASKS_START = 1;
     while (spiBaseAddress->EVENTS_END == 0)
       ;
-    nrf_gpio_pin_set(this->pinCsn);
-    currentBufferAddr = 0;
-
     DisableWorkaroundForErratum58();
-
-    xSemaphoreGive(mutex);
+    return false;
   }
 
-  return true;
+  phase = Phase::Command;
+  if (transaction.commandSize > 0) {
+    PrepareTx((uint32_t) transaction.command.data(), transaction.commandSize);
+    spiBaseAddress->TASKS_START = 1;
+    return true;
+  }
+  return StartNextPhase();
 }
 
-bool SpiMaster::Read(uint8_t pinCsn, uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize) {
-  xSemaphoreTake(mutex, portMAX_DELAY);
+bool SpiMaster::StartNextPhase() {
+  auto& transaction = queue[queueHead];
 
-  this->pinCsn = pinCsn;
-  DisableWorkaroundForErratum58();
-  spiBaseAddress->INTENCLR = (1 << 6);
-  spiBaseAddress->INTENCLR = (1 << 1);
-  spiBaseAddress->INTENCLR = (1 << 19);
+  if (phase == Phase::Command && transaction.postCommandHook != nullptr) {
+    transaction.postCommandHook();
+  }
 
-  nrf_gpio_pin_clear(this->pinCsn);
+  if (phase == Phase::Command && transaction.txSize > 0) {
+    phase = Phase::Transmit;
+    currentBufferAddr = (uint32_t) transaction.txData;
+    currentBufferSize = transaction.txSize;
+    if (const size_t chunkSize = ChainedChunkSize(currentBufferSize, maxChunkSize); chunkSize != 0) {
+      StartChainedTransfer(chunkSize);
+    } else {
+      ContinueBuffer();
+    }
+    return true;
+  }
 
-  currentBufferAddr = 0;
-  currentBufferSize = 0;
+  if (phase != Phase::Receive && transaction.rxSize > 0) {
+    phase = Phase::Receive;
+    currentBufferAddr = (uint32_t) transaction.rxData;
+    currentBufferSize = transaction.rxSize;
+    ContinueBuffer();
+    return true;
+  }
 
-  PrepareTx((uint32_t) cmd, cmdSize);
-  spiBaseAddress->TASKS_START = 1;
-  while (spiBaseAddress->EVENTS_END == 0)
-    ;
+  return false;
+}
+
+void SpiMaster::ContinueBuffer() {
+  auto currentSize = std::min(maxChunkSize, (size_t) currentBufferSize);
+  if (phase == Phase::Receive) {
+    PrepareRx(currentBufferAddr, currentSize);
+  } else {
+    PrepareTx(currentBufferAddr, currentSize);
+  }
+  currentBufferAddr = currentBufferAddr + currentSize;
+  currentBufferSize = currentBufferSize - currentSize;
 
-  PrepareRx((uint32_t) data, dataSize);
   spiBaseAddress->TASKS_START = 1;
+}
 
-  while (spiBaseAddress->EVENTS_END == 0)
-    ;
+void SpiMaster::CompleteTransaction() {
   nrf_gpio_pin_set(this->pinCsn);
+  currentBufferAddr = 0;
+  currentBufferSize = 0;
 
-  xSemaphoreGive(mutex);
+  auto& transaction = queue[queueHead];
+  if (transaction.onCompleted != nullptr) {
+    transaction.onCompleted();
+  }
+  transaction = {};
 
-  return true;
+  queueHead = (queueHead + 1) % queueSize;
+  queueCount--;
+
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+  xSemaphoreGiveFromISR(freeSlots, &xHigherPriorityTaskWoken);
+  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
 void SpiMaster::Sleep() {
@@ -268,34 +510,3 @@ void SpiMaster::Wakeup() {
   Init();
   NRF_LOG_INFO("[SPIMASTER] Wakeup");
 }
-
-bool SpiMaster::WriteCmdAndBuffer(uint8_t pinCsn, const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize) {
-  xSemaphoreTake(mutex, portMAX_DELAY);
-
-  this->pinCsn = pinCsn;
-  DisableWorkaroundForErratum58();
-  spiBaseAddress->INTENCLR = (1 << 6);
-  spiBaseAddress->INTENCLR = (1 << 1);
-  spiBaseAddress->INTENCLR = (1 << 19);
-
-  nrf_gpio_pin_clear(this->pinCsn);
-
-  currentBufferAddr = 0;
-  currentBufferSize = 0;
-
-  PrepareTx((uint32_t) cmd, cmdSize);
-  spiBaseAddress->TASKS_START = 1;
-  while (spiBaseAddress->EVENTS_END == 0)
-    ;
-
-  PrepareTx((uint32_t) data, dataSize);
-  spiBaseAddress->TASKS_START = 1;
-
-  while (spiBaseAddress->EVENTS_END == 0)
-    ;
-  nrf_gpio_pin_set(this->pinCsn);
-
-  xSemaphoreGive(mutex);
-
-  return true;
-}
@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
@@ -8,6 +9,7 @@
 #include <task.h>
 #include "nrfx_gpiote.h"
 #include "nrf_ppi.h"
+#include "nrf_timer.h"
 
 namespace Pinetime {
   namespace Drivers {
@@ -27,6 +29,24 @@ namespace Pinetime {
         uint8_t pinMISO;
       };
 
+      // A transaction selects the device (CS low), runs the optional hook, sends the command bytes,
+      // runs the optional post-command hook, then transmits txData and/or receives rxData before releasing CS.
+      struct Transaction {
+        uint8_t pinCsn = 0;
+        // The command is copied into the transaction, the caller doesn't have to keep it alive
+        std::array<uint8_t, 8> command = {};
+        uint8_t commandSize = 0;
+        const uint8_t* txData = nullptr;
+        size_t txSize = 0;
+        uint8_t* rxData = nullptr;
+        size_t rxSize = 0;
+        std::function<void()> preTransactionHook;
+        // Called between the command and the data phases (ex: to switch a data/command pin)
+        std::function<void()> postCommandHook;
+        // Called from the SPI interrupt once CS is released, must not block
+        std::function<void()> onCompleted;
+      };
+
       SpiMaster(const SpiModule spi, const Parameters& params);
       SpiMaster(const SpiMaster&) = delete;
       SpiMaster& operator=(const SpiMaster&) = delete;
@@ -34,22 +54,61 @@ namespace Pinetime {
       SpiMaster& operator=(SpiMaster&&) = delete;
 
       bool Init();
+
+      // Adds the transaction to the queue and returns immediately. Blocks only if the queue is full.
+      // The data buffers must remain valid until onCompleted is called.
+      bool Enqueue(Transaction transaction);
+      // Same as Enqueue(), but the calling task sleeps until the transaction is done
+      bool Transfer(Transaction transaction);
+
+      // Blocking variants: the calling task sleeps until the transaction is done
       bool Write(uint8_t pinCsn, const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook);
       bool Read(uint8_t pinCsn, uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize);
-
       bool WriteCmdAndBuffer(uint8_t pinCsn, const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize);
 
+      bool WriteAsync(uint8_t pinCsn,
+                      const uint8_t* data,
+                      size_t size,
+                      const std::function<void()>& preTransactionHook,
+                      std::function<void()> onCompleted);
+      bool ReadAsync(uint8_t pinCsn, const uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize, std::function<void()> onCompleted);
+      bool WriteCmdAndBufferAsync(uint8_t pinCsn,
+                                  const uint8_t* cmd,
+                                  size_t cmdSize,
+                                  const uint8_t* data,
+                                  size_t dataSize,
+                                  std::function<void()> onCompleted);
+
       void OnStartedEvent();
       void OnEndEvent();
+      void OnChainedTransferEndEvent();
 
       void Sleep();
       void Wakeup();
 
     private:
+      enum class Phase : uint8_t { Command, Transmit, Receive };
+
+      static bool MakeTransaction(Transaction& transaction,
+                                  uint8_t pinCsn,
+                                  const uint8_t* cmd,
+                                  size_t cmdSize,
+                                  const uint8_t* txData,
+                                  size_t txSize,
+                                  uint8_t* rxData,
+                                  size_t rxSize);
+      void StartNextTransaction();
+      bool StartTransaction();
+      bool StartNextPhase();
+      void ContinueBuffer();
+      void CompleteTransaction();
+
       void SetupWorkaroundForErratum58();
       void DisableWorkaroundForErratum58();
       void PrepareTx(const volatile uint32_t bufferAddress, const volatile size_t size);
       void PrepareRx(const volatile uint32_t bufferAddress, const volatile size_t size);
+      void StartChainedTransfer(size_t chunkSize);
+      void StopChainedTransfer();
 
       NRF_SPIM_Type* spiBaseAddress;
       uint8_t pinCsn;
@@ -59,9 +118,29 @@ namespace Pinetime {
 
       volatile uint32_t currentBufferAddr = 0;
       volatile size_t currentBufferSize = 0;
-      SemaphoreHandle_t mutex = nullptr;
+
+      static constexpr size_t queueSize = 8;
+      std::array<Transaction, queueSize> queue;
+      size_t queueHead = 0;
+      size_t queueCount = 0;
+      volatile bool busy = false;
+      Phase phase = Phase::Command;
+      SemaphoreHandle_t freeSlots = nullptr;
+      SemaphoreHandle_t syncMutex = nullptr;
+      SemaphoreHandle_t syncDone = nullptr;
       static constexpr nrf_ppi_channel_t workaroundPpi = NRF_PPI_CHANNEL0;
       bool workaroundActive = false;
+
+      // Buffers made of 2 or more equal chunks are sent as a chain of chunks in ArrayList mode:
+      // END restarts the SPIM through PPI and TIMER1 counts the chunks, so the CPU is only interrupted
+      // once the whole chain is done.
+      static constexpr size_t maxChunkSize = 255;
+      static constexpr nrf_ppi_channel_t chainCountPpi = NRF_PPI_CHANNEL3;
+      static constexpr nrf_ppi_channel_t chainRestartPpi = NRF_PPI_CHANNEL6;
+      static constexpr nrf_ppi_channel_t chainStopPpi = NRF_PPI_CHANNEL7;
+      static constexpr nrf_ppi_channel_group_t chainPpiGroup = NRF_PPI_CHANNEL_GROUP0;
+      NRF_TIMER_Type* const chainTimer = NRF_TIMER1;
+      bool chainActive = false;
     };
   }
 }
@@ -77,6 +77,20 @@ void SpiNorFlash::Read(uint32_t address, uint8_t* buffer, size_t size) {
                           static_cast<uint8_t>(address >> 8U),
                           static_cast<uint8_t>(address)};
   spi.Read(reinterpret_cast<uint8_t*>(&cmd), cmdSize, buffer, size);
+  statistics.bytesRead += size;
+}
+
+bool SpiNorFlash::ReadAsync(uint32_t address, uint8_t* buffer, size_t size, std::function<void()> onCompleted) {
+  static constexpr uint8_t cmdSize = 4;
+  uint8_t cmd[cmdSize] = {static_cast<uint8_t>(Commands::Read),
+                          static_cast<uint8_t>(address >> 16U),
+                          static_cast<uint8_t>(address >> 8U),
+                          static_cast<uint8_t>(address)};
+  if (!spi.ReadAsync(cmd, cmdSize, buffer, size, std::move(onCompleted))) {
+    return false;
+  }
+  statistics.bytesRead += size;
+  return true;
 }
 
 void SpiNorFlash::WriteEnable() {
@@ -85,20 +99,68 @@ void SpiNorFlash::WriteEnable() {
 }
 
 void SpiNorFlash::SectorErase(uint32_t sectorAddress) {
+  EraseCommand(static_cast<uint8_t>(Commands::SectorErase), sectorAddress);
+  statistics.bytesErased += sectorSize;
+}
+
+void SpiNorFlash::BlockErase(uint32_t blockAddress) {
+  EraseCommand(static_cast<uint8_t>(Commands::BlockErase), blockAddress);
+  statistics.bytesErased += blockSize;
+}
+
+void SpiNorFlash::Erase(uint32_t address, size_t size) {
+  uint32_t addr = address & ~(sectorSize - 1u);
+  const uint32_t end = address + size;
+  while (addr < end) {
+    if ((addr & (blockSize - 1u)) == 0 && end - addr >= blockSize) {
+      BlockErase(addr);
+      addr += blockSize;
+    } else {
+      SectorErase(addr);
+      addr += sectorSize;
+    }
+  }
+}
+
+void SpiNorFlash::EraseCommand(uint8_t command, uint32_t address) {
   static constexpr uint8_t cmdSize = 4;
-  uint8_t cmd[cmdSize] = {static_cast<uint8_t>(Commands::SectorErase),
-                          static_cast<uint8_t>(sectorAddress >> 16U),
-                          static_cast<uint8_t>(sectorAddress >> 8U),
-                          static_cast<uint8_t>(sectorAddress)};
+  uint8_t cmd[cmdSize] = {command,
+                          static_cast<uint8_t>(address >> 16U),
+                          static_cast<uint8_t>(address >> 8U),
+                          static_cast<uint8_t>(address)};
 
   WriteEnable();
-  while (!WriteEnabled())
-    vTaskDelay(1);
+  WaitWriteEnabled();
 
   spi.Read(reinterpret_cast<uint8_t*>(&cmd), cmdSize, nullptr, 0);
 
-  while (WriteInProgress())
+  // Erasing takes tens to hundreds of milliseconds, there is no point in spinning
+  WaitWhileBusy(0);
+}
+
+void SpiNorFlash::WaitWriteEnabled() {
+  // WEL is set as soon as the WriteEnable command is latched, the first read almost always succeeds
+  while (true) {
+    statistics.statusPolls++;
+    if (WriteEnabled()) {
+      return;
+    }
+    statistics.yields++;
     vTaskDelay(1);
+  }
+}
+
+void SpiNorFlash::WaitWhileBusy(uint32_t pollsBeforeYield) {
+  for (uint32_t polls = 0;; polls++) {
+    statistics.statusPolls++;
+    if (!WriteInProgress()) {
+      return;
+    }
+    if (polls >= pollsBeforeYield) {
+      statistics.yields++;
+      vTaskDelay(1);
+    }
+  }
 }
 
 uint8_t SpiNorFlash::ReadSecurityRegister() {
@@ -132,18 +194,17 @@ void SpiNorFlash::Write(uint32_t address, const uint8_t* buffer, size_t size) {
                             static_cast<uint8_t>(addr)};
 
     WriteEnable();
-    while (!WriteEnabled())
-      vTaskDelay(1);
+    WaitWriteEnabled();
 
     spi.WriteCmdAndBuffer(cmd, cmdSize, b, toWrite);
 
-    while (WriteInProgress())
-      vTaskDelay(1);
+    WaitWhileBusy(pageProgramPolls);
 
     addr += toWrite;
     b += toWrite;
     len -= toWrite;
   }
+  statistics.bytesWritten += size;
 }
 
 SpiNorFlash::Identification SpiNorFlash::GetIdentification() const {
@@ -1,6 +1,7 @@
 #pragma once
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 
 namespace Pinetime {
   namespace Drivers {
@@ -20,19 +21,35 @@ namespace Pinetime {
         uint8_t density = 0;
       };
 
+      struct Statistics {
+        uint32_t bytesRead = 0;
+        uint32_t bytesWritten = 0;
+        uint32_t bytesErased = 0;
+        uint32_t statusPolls = 0;
+        uint32_t yields = 0;
+      };
+
       uint8_t ReadStatusRegister();
       bool WriteInProgress();
       bool WriteEnabled();
       uint8_t ReadConfigurationRegister();
       void Read(uint32_t address, uint8_t* buffer, size_t size);
+      // Returns immediately, onCompleted is called from the SPI interrupt once buffer is filled
+      bool ReadAsync(uint32_t address, uint8_t* buffer, size_t size, std::function<void()> onCompleted);
       void Write(uint32_t address, const uint8_t* buffer, size_t size);
       void WriteEnable();
       void SectorErase(uint32_t sectorAddress);
+      void BlockErase(uint32_t blockAddress);
+      // Erases [address, address + size), using 64KB block erases wherever the range allows it
+      void Erase(uint32_t address, size_t size);
       uint8_t ReadSecurityRegister();
       bool ProgramFailed();
       bool EraseFailed();
 
       Identification GetIdentification() const;
+      const Statistics& GetStatistics() const {
+        return statistics;
+      }
 
       void Init();
       void Uninit();
@@ -42,6 +59,9 @@ namespace Pinetime {
 
     private:
       Identification ReadIdentification();
+      void EraseCommand(uint8_t command, uint32_t address);
+      void WaitWriteEnabled();
+      void WaitWhileBusy(uint32_t pollsBeforeYield);
 
       enum class Commands : uint8_t {
         PageProgram = 0x02,
@@ -53,12 +73,19 @@ namespace Pinetime {
         ReadSecurityRegister = 0x2B,
         ReadIdentification = 0x9F,
         ReleaseFromDeepPowerDown = 0xAB,
-        DeepPowerDown = 0xB9
+        DeepPowerDown = 0xB9,
+        BlockErase = 0xD8
       };
       static constexpr uint16_t pageSize = 256;
+      static constexpr uint32_t sectorSize = 0x1000;
+      static constexpr uint32_t blockSize = 0x10000;
+      // A page program completes in less than a millisecond: keep polling the status register
+      // for a while instead of sleeping for a whole tick after each page.
+      static constexpr uint32_t pageProgramPolls = 64;
 
       Spi& spi;
       Identification device_id;
+      Statistics statistics;
     };
   }
 }
@@ -1,4 +1,3 @@
-#include <cstring>
 #include "drivers/St7789.h"
 #include <hal/nrf_gpio.h>
 #include <nrfx_log.h>
@@ -7,6 +6,23 @@
 
 using namespace Pinetime::Drivers;
 
+namespace {
+  SpiMaster::Transaction CommandTransaction(uint8_t pinDataCommand, uint8_t cmd, const uint8_t* data, size_t size) {
+    SpiMaster::Transaction transaction;
+    transaction.command[0] = cmd;
+    transaction.commandSize = 1;
+    transaction.txData = data;
+    transaction.txSize = size;
+    transaction.preTransactionHook = [pinDataCommand]() {
+      nrf_gpio_pin_clear(pinDataCommand);
+    };
+    transaction.postCommandHook = [pinDataCommand]() {
+      nrf_gpio_pin_set(pinDataCommand);
+    };
+    return transaction;
+  }
+}
+
 St7789::St7789(Spi& spi, uint8_t pinDataCommand, uint8_t pinReset) : spi {spi}, pinDataCommand {pinDataCommand}, pinReset {pinReset} {
 }
 
@@ -55,6 +71,11 @@ void St7789::WriteCommand(const uint8_t* data, size_t size) {
   });
 }
 
+// Sends the command (DC low) and its parameters (DC high) in a single SPI transaction
+void St7789::WriteCommandAndData(uint8_t cmd, const uint8_t* data, size_t size) {
+  spi.Transfer(CommandTransaction(pinDataCommand, cmd, data, size));
+}
+
 void St7789::WriteSpi(const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook) {
   spi.Write(data, size, preTransactionHook);
 }
@@ -66,6 +87,7 @@ void St7789::SoftwareReset() {
   // Unconditionally wait as software reset doesn't need to be performant
   sleepIn = true;
   lastSleepExit = xTaskGetTickCount();
+  addrWindowValid = false;
   vTaskDelay(pdMS_TO_TICKS(125));
 }
 
@@ -217,29 +239,33 @@ void St7789::GateControl() {
 }
 
 void St7789::SetAddrWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
-  WriteCommand(static_cast<uint8_t>(Commands::ColumnAddressSet));
-  uint8_t colArgs[] = {
-    static_cast<uint8_t>(x0 >> 8), // x start MSB
-    static_cast<uint8_t>(x0),      // x start LSB
-    static_cast<uint8_t>(x1 >> 8), // x end MSB
-    static_cast<uint8_t>(x1)       // x end LSB
-  };
-  WriteData(colArgs, sizeof(colArgs));
+  if (!addrWindowValid || x0 != addrWindowX0 || x1 != addrWindowX1) {
+    uint8_t colArgs[] = {
+      static_cast<uint8_t>(x0 >> 8), // x start MSB
+      static_cast<uint8_t>(x0),      // x start LSB
+      static_cast<uint8_t>(x1 >> 8), // x end MSB
+      static_cast<uint8_t>(x1)       // x end LSB
+    };
+    WriteCommandAndData(static_cast<uint8_t>(Commands::ColumnAddressSet), colArgs, sizeof(colArgs));
+    addrWindowX0 = x0;
+    addrWindowX1 = x1;
+    addrWindowValid = true;
+  }
 
-  WriteCommand(static_cast<uint8_t>(Commands::RowAddressSet));
   uint8_t rowArgs[] = {
     static_cast<uint8_t>(y0 >> 8), // y start MSB
     static_cast<uint8_t>(y0),      // y start LSB
     static_cast<uint8_t>(y1 >> 8), // y end MSB
     static_cast<uint8_t>(y1)       // y end LSB
   };
-  memcpy(addrWindowArgs, rowArgs, sizeof(rowArgs));
-  WriteData(addrWindowArgs, sizeof(addrWindowArgs));
+  WriteCommandAndData(static_cast<uint8_t>(Commands::RowAddressSet), rowArgs, sizeof(rowArgs));
 }
 
-void St7789::WriteToRam(const uint8_t* data, size_t size) {
-  WriteCommand(static_cast<uint8_t>(Commands::WriteToRam));
-  WriteData(data, size);
+void St7789::WriteToRam(bool continuation, const uint8_t* data, size_t size, std::function<void()> onCompleted) {
+  auto command = continuation ? Commands::WriteToRamContinue : Commands::WriteToRam;
+  auto transaction = CommandTransaction(pinDataCommand, static_cast<uint8_t>(command), data, size);
+  transaction.onCompleted = std::move(onCompleted);
+  spi.Enqueue(std::move(transaction));
 }
 
 void St7789::SetVdv() {
@@ -255,21 +281,32 @@ void St7789::DisplayOff() {
 
 void St7789::VerticalScrollStartAddress(uint16_t line) {
   verticalScrollingStartAddress = line;
-  WriteCommand(static_cast<uint8_t>(Commands::VerticalScrollStartAddress));
   uint8_t args[] = {
     static_cast<uint8_t>(line >> 8), // Frame memory line pointer MSB
     static_cast<uint8_t>(line)       // Frame memory line pointer LSB
   };
-  memcpy(verticalScrollArgs, args, sizeof(args));
-  WriteData(verticalScrollArgs, sizeof(verticalScrollArgs));
+  WriteCommandAndData(static_cast<uint8_t>(Commands::VerticalScrollStartAddress), args, sizeof(args));
 }
 
 void St7789::Uninit() {
 }
 
-void St7789::DrawBuffer(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* data, size_t size) {
-  SetAddrWindow(x, y, x + width - 1, y + height - 1);
-  WriteToRam(data, size);
+void St7789::DrawBuffer(uint16_t x,
+                        uint16_t y,
+                        uint16_t width,
+                        uint16_t height,
+                        const uint8_t* data,
+                        size_t size,
+                        std::function<void()> onCompleted) {
+  // LVGL flushes the screen in bands from top to bottom: when a band starts right below the previous one,
+  // the pixels are appended to the RAM without sending the address window again.
+  const uint16_t x1 = x + width - 1;
+  const bool continuation = addrWindowValid && x == addrWindowX0 && x1 == addrWindowX1 && y == nextRamLine;
+  if (!continuation) {
+    SetAddrWindow(x, y, x1, Height - 1);
+  }
+  WriteToRam(continuation, data, size, std::move(onCompleted));
+  nextRamLine = y + height;
 }
 
 void St7789::HardwareReset() {
@@ -280,6 +317,7 @@ void St7789::HardwareReset() {
   // Unconditionally wait as hardware reset doesn't need to be performant
   sleepIn = true;
   lastSleepExit = xTaskGetTickCount();
+  addrWindowValid = false;
   vTaskDelay(pdMS_TO_TICKS(125));
 }
 
@@ -297,6 +335,7 @@ void St7789::LowPowerOff() {
 
 void St7789::Sleep() {
   SleepIn();
+  addrWindowValid = false;
   nrf_gpio_cfg_default(pinDataCommand);
   NRF_LOG_INFO("[LCD] Sleep");
 }
@@ -22,7 +22,15 @@ namespace Pinetime {
 
       void VerticalScrollStartAddress(uint16_t line);
 
-      void DrawBuffer(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* data, size_t size);
+      // The pixel data is sent asynchronously: data must remain valid until onCompleted is called (from the SPI interrupt).
+      // The next command sent to the display waits until the transfer is done.
+      void DrawBuffer(uint16_t x,
+                      uint16_t y,
+                      uint16_t width,
+                      uint16_t height,
+                      const uint8_t* data,
+                      size_t size,
+                      std::function<void()> onCompleted = nullptr);
 
       void LowPowerOn();
       void LowPowerOff();
@@ -47,7 +55,7 @@ namespace Pinetime {
       void MemoryDataAccessControl();
       void DisplayInversionOn();
       void NormalModeOn();
-      void WriteToRam(const uint8_t* data, size_t size);
+      void WriteToRam(bool continuation, const uint8_t* data, size_t size, std::function<void()> onCompleted);
       void IdleModeOn();
       void IdleModeOff();
       void FrameRateNormalSet();
@@ -63,6 +71,7 @@ namespace Pinetime {
       void SetVdv();
       void WriteCommand(uint8_t cmd);
       void WriteCommand(const uint8_t* data, size_t size);
+      void WriteCommandAndData(uint8_t cmd, const uint8_t* data, size_t size);
       void WriteSpi(const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook);
 
       enum class Commands : uint8_t {
@@ -76,6 +85,7 @@ namespace Pinetime {
         ColumnAddressSet = 0x2a,
         RowAddressSet = 0x2b,
         WriteToRam = 0x2c,
+        WriteToRamContinue = 0x3c,
         MemoryDataAccessControl = 0x36,
         VerticalScrollDefinition = 0x33,
         VerticalScrollStartAddress = 0x37,
@@ -97,8 +107,12 @@ namespace Pinetime {
       static constexpr uint16_t Width = 240;
       static constexpr uint16_t Height = 320;
 
-      uint8_t addrWindowArgs[4];
-      uint8_t verticalScrollArgs[2];
+      // Address window currently set in the controller. The row range always extends to the end of the display RAM,
+      // so that a band starting right below the previous one can be written with WriteToRamContinue.
+      bool addrWindowValid = false;
+      uint16_t addrWindowX0 = 0;
+      uint16_t addrWindowX1 = 0;
+      uint16_t nextRamLine = 0;
     };
   }
 }
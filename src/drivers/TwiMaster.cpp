@@ -5,9 +5,6 @@
 
 using namespace Pinetime::Drivers;
 
-// TODO use shortcut to automatically send STOP when receive LastTX, for example
-// TODO use DMA/IRQ
-
 TwiMaster::TwiMaster(NRF_TWIM_Type* module, uint32_t frequency, uint8_t pinSda, uint8_t pinScl)
   : module {module}, frequency {frequency}, pinSda {pinSda}, pinScl {pinScl} {
 }
@@ -25,6 +22,7 @@ void TwiMaster::ConfigurePins() const {
 void TwiMaster::Init() {
   if (mutex == nullptr) {
     mutex = xSemaphoreCreateBinary();
+    transferDone = xSemaphoreCreateBinary();
   }
 
   ConfigurePins();
@@ -43,116 +41,129 @@ void TwiMaster::Init() {
   twiBaseAddress->EVENTS_SUSPENDED = 0;
   twiBaseAddress->EVENTS_TXSTARTED = 0;
 
-  twiBaseAddress->ENABLE = (TWIM_ENABLE_ENABLE_Enabled << TWIM_ENABLE_ENABLE_Pos);
+  twiBaseAddress->INTENSET = TWIM_INTENSET_STOPPED_Msk | TWIM_INTENSET_ERROR_Msk;
+  NRFX_IRQ_PRIORITY_SET(nrfx_get_irq_number(twiBaseAddress), 2);
+  NRFX_IRQ_ENABLE(nrfx_get_irq_number(twiBaseAddress));
 
   xSemaphoreGive(mutex);
 }
 
 TwiMaster::ErrorCodes TwiMaster::Read(uint8_t deviceAddress, uint8_t registerAddress, uint8_t* data, size_t size) {
-  xSemaphoreTake(mutex, portMAX_DELAY);
-  Wakeup();
-  auto ret = Write(deviceAddress, &registerAddress, 1, false);
-  ret = Read(deviceAddress, data, size, true);
-  Sleep();
-  xSemaphoreGive(mutex);
-  return ret;
+  Transaction transaction;
+  transaction.deviceAddress = deviceAddress;
+  transaction.registerAddress = registerAddress;
+  transaction.rxData = data;
+  transaction.rxSize = size;
+  return Transfer(&transaction, 1);
 }
 
 TwiMaster::ErrorCodes TwiMaster::Write(uint8_t deviceAddress, uint8_t registerAddress, const uint8_t* data, size_t size) {
-  ASSERT(size <= maxDataSize);
-  xSemaphoreTake(mutex, portMAX_DELAY);
-  Wakeup();
-  internalBuffer[0] = registerAddress;
-  std::memcpy(internalBuffer + 1, data, size);
-  auto ret = Write(deviceAddress, internalBuffer, size + 1, true);
-  Sleep();
-  xSemaphoreGive(mutex);
-  return ret;
+  Transaction transaction;
+  transaction.deviceAddress = deviceAddress;
+  transaction.registerAddress = registerAddress;
+  transaction.txData = data;
+  transaction.txSize = size;
+  return Transfer(&transaction, 1);
 }
 
-TwiMaster::ErrorCodes TwiMaster::Read(uint8_t deviceAddress, uint8_t* buffer, size_t size, bool stop) {
-  twiBaseAddress->ADDRESS = deviceAddress;
-  twiBaseAddress->TASKS_RESUME = 0x1UL;
-  twiBaseAddress->RXD.PTR = (uint32_t) buffer;
-  twiBaseAddress->RXD.MAXCNT = size;
-
-  twiBaseAddress->TASKS_STARTRX = 1;
-
-  while (!twiBaseAddress->EVENTS_RXSTARTED && !twiBaseAddress->EVENTS_ERROR)
-    ;
-  twiBaseAddress->EVENTS_RXSTARTED = 0x0UL;
-
-  txStartedCycleCount = DWT->CYCCNT;
-  uint32_t currentCycleCount;
-  while (!twiBaseAddress->EVENTS_LASTRX && !twiBaseAddress->EVENTS_ERROR) {
-    currentCycleCount = DWT->CYCCNT;
-    if ((currentCycleCount - txStartedCycleCount) > HwFreezedDelay) {
-      FixHwFreezed();
-      return ErrorCodes::TransactionFailed;
-    }
+TwiMaster::ErrorCodes TwiMaster::Transfer(Transaction* transactions, size_t count) {
+  if (count == 0) {
+    return ErrorCodes::NoError;
   }
-  twiBaseAddress->EVENTS_LASTRX = 0x0UL;
+  for (size_t i = 0; i < count; i++) {
+    ASSERT(transactions[i].txSize <= maxDataSize);
+  }
+
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  Wakeup();
+  this->transactions = transactions;
+  transactionCount = count;
+  currentTransaction = 0;
+
+  taskENTER_CRITICAL();
+  StartTransaction();
+  taskEXIT_CRITICAL();
 
-  if (stop || twiBaseAddress->EVENTS_ERROR) {
-    twiBaseAddress->TASKS_STOP = 0x1UL;
-    while (!twiBaseAddress->EVENTS_STOPPED)
-      ;
-    twiBaseAddress->EVENTS_STOPPED = 0x0UL;
+  ErrorCodes result;
+  if (xSemaphoreTake(transferDone, transactionTimeout * count) == pdTRUE) {
+    result = transferResult;
   } else {
-    twiBaseAddress->TASKS_SUSPEND = 0x1UL;
-    while (!twiBaseAddress->EVENTS_SUSPENDED)
-      ;
-    twiBaseAddress->EVENTS_SUSPENDED = 0x0UL;
+    twiBaseAddress->INTENCLR = TWIM_INTENCLR_STOPPED_Msk | TWIM_INTENCLR_ERROR_Msk;
+    this->transactions = nullptr;
+    FixHwFreezed();
+    // The transfer may have completed between the timeout and the interrupts being disabled
+    xSemaphoreTake(transferDone, 0);
+    twiBaseAddress->EVENTS_STOPPED = 0;
+    twiBaseAddress->EVENTS_ERROR = 0;
+    twiBaseAddress->INTENSET = TWIM_INTENSET_STOPPED_Msk | TWIM_INTENSET_ERROR_Msk;
+    result = ErrorCodes::TransactionFailed;
   }
 
-  if (twiBaseAddress->EVENTS_ERROR) {
-    twiBaseAddress->EVENTS_ERROR = 0x0UL;
-  }
-  return ErrorCodes::NoError;
+  Sleep();
+  xSemaphoreGive(mutex);
+  return result;
 }
 
-TwiMaster::ErrorCodes TwiMaster::Write(uint8_t deviceAddress, const uint8_t* data, size_t size, bool stop) {
-  twiBaseAddress->ADDRESS = deviceAddress;
-  twiBaseAddress->TASKS_RESUME = 0x1UL;
-  twiBaseAddress->TXD.PTR = (uint32_t) data;
-  twiBaseAddress->TXD.MAXCNT = size;
-
+// Called with the interrupts masked (critical section or TWI interrupt)
+void TwiMaster::StartTransaction() {
+  const auto& transaction = transactions[currentTransaction];
+  transactionError = false;
+
+  twiBaseAddress->ADDRESS = transaction.deviceAddress;
+  if (transaction.rxSize > 0) {
+    // Register address, then repeated start and read, then stop
+    twiBaseAddress->TXD.PTR = (uint32_t) &transaction.registerAddress;
+    twiBaseAddress->TXD.MAXCNT = registerSize;
+    twiBaseAddress->RXD.PTR = (uint32_t) transaction.rxData;
+    twiBaseAddress->RXD.MAXCNT = transaction.rxSize;
+    twiBaseAddress->SHORTS = TWIM_SHORTS_LASTTX_STARTRX_Msk | TWIM_SHORTS_LASTRX_STOP_Msk;
+  } else {
+    internalBuffer[0] = transaction.registerAddress;
+    std::memcpy(internalBuffer + registerSize, transaction.txData, transaction.txSize);
+    twiBaseAddress->TXD.PTR = (uint32_t) internalBuffer;
+    twiBaseAddress->TXD.MAXCNT = registerSize + transaction.txSize;
+    twiBaseAddress->SHORTS = TWIM_SHORTS_LASTTX_STOP_Msk;
+  }
   twiBaseAddress->TASKS_STARTTX = 1;
+}
 
-  while (!twiBaseAddress->EVENTS_TXSTARTED && !twiBaseAddress->EVENTS_ERROR)
-    ;
-  twiBaseAddress->EVENTS_TXSTARTED = 0x0UL;
-
-  txStartedCycleCount = DWT->CYCCNT;
-  uint32_t currentCycleCount;
-  while (!twiBaseAddress->EVENTS_LASTTX && !twiBaseAddress->EVENTS_ERROR) {
-    currentCycleCount = DWT->CYCCNT;
-    if ((currentCycleCount - txStartedCycleCount) > HwFreezedDelay) {
-      FixHwFreezed();
-      return ErrorCodes::TransactionFailed;
-    }
+void TwiMaster::OnErrorEvent() {
+  // The peripheral doesn't stop by itself on errors (ex: NACK)
+  if (!transactionError) {
+    transactionError = true;
+    twiBaseAddress->TASKS_RESUME = 1;
+    twiBaseAddress->TASKS_STOP = 1;
   }
-  twiBaseAddress->EVENTS_LASTTX = 0x0UL;
+}
 
-  if (stop || twiBaseAddress->EVENTS_ERROR) {
-    twiBaseAddress->TASKS_STOP = 0x1UL;
-    while (!twiBaseAddress->EVENTS_STOPPED)
-      ;
-    twiBaseAddress->EVENTS_STOPPED = 0x0UL;
-  } else {
-    twiBaseAddress->TASKS_SUSPEND = 0x1UL;
-    while (!twiBaseAddress->EVENTS_SUSPENDED)
-      ;
-    twiBaseAddress->EVENTS_SUSPENDED = 0x0UL;
+void TwiMaster::OnStoppedEvent() {
+  if (transactions == nullptr) {
+    return;
   }
 
-  if (twiBaseAddress->EVENTS_ERROR) {
-    twiBaseAddress->EVENTS_ERROR = 0x0UL;
+  if (transactionError) {
     uint32_t error = twiBaseAddress->ERRORSRC;
     twiBaseAddress->ERRORSRC = error;
+    CompleteTransfer(ErrorCodes::TransactionFailed);
+    return;
   }
 
-  return ErrorCodes::NoError;
+  currentTransaction++;
+  if (currentTransaction < transactionCount) {
+    StartTransaction();
+  } else {
+    CompleteTransfer(ErrorCodes::NoError);
+  }
+}
+
+void TwiMaster::CompleteTransfer(ErrorCodes result) {
+  twiBaseAddress->SHORTS = 0;
+  transactions = nullptr;
+  transferResult = result;
+
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+  xSemaphoreGiveFromISR(transferDone, &xHigherPriorityTaskWoken);
+  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
 void TwiMaster::Sleep() {
@@ -163,7 +174,7 @@ void TwiMaster::Wakeup() {
   twiBaseAddress->ENABLE = (TWIM_ENABLE_ENABLE_Enabled << TWIM_ENABLE_ENABLE_Pos);
 }
 
-/* Sometimes, the TWIM device just freeze and never set the event EVENTS_LASTTX.
+/* Sometimes, the TWIM device just freeze and never set the event EVENTS_STOPPED.
  * This method disable and re-enable the peripheral so that it works again.
  * This is just a workaround, and it would be better if we could find a way to prevent
  * this issue from happening.
@@ -2,6 +2,7 @@
 #include <FreeRTOS.h>
 #include <semphr.h>
 #include <drivers/include/nrfx_twi.h> // NRF_TWIM_Type
+#include <cstddef>
 #include <cstdint>
 
 namespace Pinetime {
@@ -10,23 +11,42 @@ namespace Pinetime {
     public:
       enum class ErrorCodes { NoError, TransactionFailed };
 
+      // A register access: sends the register address, then either writes txData (at most maxDataSize bytes)
+      // or reads rxData after a repeated start.
+      struct Transaction {
+        uint8_t deviceAddress = 0;
+        uint8_t registerAddress = 0;
+        const uint8_t* txData = nullptr;
+        size_t txSize = 0;
+        uint8_t* rxData = nullptr;
+        size_t rxSize = 0;
+      };
+
       TwiMaster(NRF_TWIM_Type* module, uint32_t frequency, uint8_t pinSda, uint8_t pinScl);
 
       void Init();
       ErrorCodes Read(uint8_t deviceAddress, uint8_t registerAddress, uint8_t* buffer, size_t size);
       ErrorCodes Write(uint8_t deviceAddress, uint8_t registerAddress, const uint8_t* data, size_t size);
 
+      // Runs the transactions back to back, without disabling the bus in between. The calling task sleeps until
+      // they are done. Stops at the first failed transaction.
+      ErrorCodes Transfer(Transaction* transactions, size_t count);
+
+      void OnStoppedEvent();
+      void OnErrorEvent();
+
       void Sleep();
       void Wakeup();
 
     private:
-      ErrorCodes Read(uint8_t deviceAddress, uint8_t* buffer, size_t size, bool stop);
-      ErrorCodes Write(uint8_t deviceAddress, const uint8_t* data, size_t size, bool stop);
+      void StartTransaction();
+      void CompleteTransfer(ErrorCodes result);
       void FixHwFreezed();
       void ConfigurePins() const;
 
       NRF_TWIM_Type* twiBaseAddress;
       SemaphoreHandle_t mutex = nullptr;
+      SemaphoreHandle_t transferDone = nullptr;
       NRF_TWIM_Type* module;
       uint32_t frequency;
       uint8_t pinSda;
@@ -34,8 +54,14 @@ namespace Pinetime {
       static constexpr uint8_t maxDataSize {16};
       static constexpr uint8_t registerSize {1};
       uint8_t internalBuffer[maxDataSize + registerSize];
-      uint32_t txStartedCycleCount = 0;
-      static constexpr uint32_t HwFreezedDelay {161000};
+
+      Transaction* transactions = nullptr;
+      size_t transactionCount = 0;
+      size_t currentTransaction = 0;
+      bool transactionError = false;
+      ErrorCodes transferResult = ErrorCodes::NoError;
+      // Sometimes the peripheral freezes and never sends STOPPED, see FixHwFreezed()
+      static constexpr TickType_t transactionTimeout = pdMS_TO_TICKS(5);
     };
   }
 }
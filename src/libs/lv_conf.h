@@ -86,9 +86,11 @@ typedef int16_t lv_coord_t;
 /* Automatically defrag. on free. Defrag. means joining the adjacent free cells. */
 #define LV_MEM_AUTO_DEFRAG  1
 #else       /*LV_MEM_CUSTOM*/
-#define LV_MEM_CUSTOM_INCLUDE <FreeRTOS.h>   /*Header for the dynamic memory function*/
-#define LV_MEM_CUSTOM_ALLOC   pvPortMalloc       /*Wrapper to malloc*/
-#define LV_MEM_CUSTOM_FREE    vPortFree         /*Wrapper to free*/
+/* Small allocations are served from slabs of fixed size objects, larger ones from the FreeRTOS heap.
+ * Use <FreeRTOS.h>, pvPortMalloc and vPortFree to allocate everything from the FreeRTOS heap. */
+#define LV_MEM_CUSTOM_INCLUDE "displayapp/LvglPool.h"   /*Header for the dynamic memory function*/
+#define LV_MEM_CUSTOM_ALLOC   LvglPoolAlloc       /*Wrapper to malloc*/
+#define LV_MEM_CUSTOM_FREE    LvglPoolFree         /*Wrapper to free*/
 #endif     /*LV_MEM_CUSTOM*/
 
 /* Use the standard memcpy and memset instead of LVGL's own functions.
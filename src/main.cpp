@@ -167,8 +167,10 @@ uint32_t NoInit_MagicWord __attribute__((section(".noinit")));
 std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> NoInit_BackUpTime __attribute__((section(".noinit")));
 
 void nrfx_gpiote_evt_handler(nrfx_gpiote_pin_t pin, nrf_gpiote_polarity_t action) {
+  portRUN_TIME_ISR_ENTER();
   if (pin == Pinetime::PinMap::Cst816sIrq) {
     systemTask.PushMessage(Pinetime::System::Messages::OnTouchEvent);
+    portRUN_TIME_ISR_EXIT(eRunTimeIsrGpiote);
     return;
   }
 
@@ -181,6 +183,7 @@ void nrfx_gpiote_evt_handler(nrfx_gpiote_pin_t pin, nrf_gpiote_polarity_t action
     xTimerStartFromISR(debounceTimer, &xHigherPriorityTaskWoken);
     portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
   }
+  portRUN_TIME_ISR_EXIT(eRunTimeIsrGpiote);
 }
 
 void DebounceTimerChargeCallback(TimerHandle_t xTimer) {
@@ -193,6 +196,7 @@ void DebounceTimerCallback(TimerHandle_t /*unused*/) {
 }
 
 void SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQHandler(void) {
+  portRUN_TIME_ISR_ENTER();
   if (((NRF_SPIM0->INTENSET & (1 << 6)) != 0) && NRF_SPIM0->EVENTS_END == 1) {
     NRF_SPIM0->EVENTS_END = 0;
     spi.OnEndEvent();
@@ -206,6 +210,7 @@ void SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQHandler(void) {
   if (((NRF_SPIM0->INTENSET & (1 << 1)) != 0) && NRF_SPIM0->EVENTS_STOPPED == 1) {
     NRF_SPIM0->EVENTS_STOPPED = 0;
   }
+  portRUN_TIME_ISR_EXIT(eRunTimeIsrSpi);
 }
 
 static void (*radio_isr_addr)();
@@ -230,6 +235,29 @@ void WDT_IRQHandler(void) {
   nrf_wdt_event_clear(NRF_WDT_EVENT_TIMEOUT);
 }
 
+void TIMER1_IRQHandler(void) {
+  portRUN_TIME_ISR_ENTER();
+  if (NRF_TIMER1->EVENTS_COMPARE[1] == 1) {
+    NRF_TIMER1->EVENTS_COMPARE[1] = 0;
+    spi.OnChainedTransferEndEvent();
+  }
+  portRUN_TIME_ISR_EXIT(eRunTimeIsrSpi);
+}
+
+void SPIM1_SPIS1_TWIM1_TWIS1_SPI1_TWI1_IRQHandler(void) {
+  portRUN_TIME_ISR_ENTER();
+  if (((NRF_TWIM1->INTENSET & TWIM_INTENSET_ERROR_Msk) != 0) && NRF_TWIM1->EVENTS_ERROR == 1) {
+    NRF_TWIM1->EVENTS_ERROR = 0;
+    twiMaster.OnErrorEvent();
+  }
+
+  if (((NRF_TWIM1->INTENSET & TWIM_INTENSET_STOPPED_Msk) != 0) && NRF_TWIM1->EVENTS_STOPPED == 1) {
+    NRF_TWIM1->EVENTS_STOPPED = 0;
+    twiMaster.OnStoppedEvent();
+  }
+  portRUN_TIME_ISR_EXIT(eRunTimeIsrTwi);
+}
+
 void npl_freertos_hw_set_isr(int irqn, void (*addr)()) {
   switch (irqn) {
     case RADIO_IRQn:
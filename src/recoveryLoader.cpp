@@ -6,6 +6,7 @@
 #include <libraries/log/nrf_log.h>
 #include <FreeRTOS.h>
 #include <task.h>
+#include <semphr.h>
 #include <legacy/nrf_drv_gpiote.h>
 #include <libraries/gpiote/app_gpiote.h>
 #include <hal/nrf_wdt.h>
@@ -72,13 +73,40 @@ void SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQHandler(void) {
     NRF_SPIM0->EVENTS_STOPPED = 0;
   }
 }
+
+void TIMER1_IRQHandler(void) {
+  if (NRF_TIMER1->EVENTS_COMPARE[1] == 1) {
+    NRF_TIMER1->EVENTS_COMPARE[1] = 0;
+    spi.OnChainedTransferEndEvent();
+  }
+}
 }
 
 void RefreshWatchdog() {
   NRF_WDT->RR[0] = WDT_RR_RR_Reload;
 }
 
-uint8_t displayBuffer[displayWidth * bytesPerPixel];
+// Lines are sent to the display asynchronously: a line buffer is only written again once the display is done
+// reading it, while the next line is decoded into the other buffer
+static constexpr uint8_t nbLineBuffers = 2;
+uint8_t displayBuffer[nbLineBuffers][displayWidth * bytesPerPixel];
+uint8_t nextLineBuffer = 0;
+SemaphoreHandle_t freeLineBuffers = nullptr;
+
+// Called from the SPI interrupt
+void OnLineSent() {
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+  xSemaphoreGiveFromISR(freeLineBuffers, &xHigherPriorityTaskWoken);
+  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+// Lines are sent in order, so the buffer used the longest time ago is the first one released
+uint8_t* TakeLineBuffer() {
+  xSemaphoreTake(freeLineBuffers, portMAX_DELAY);
+  uint8_t* buffer = displayBuffer[nextLineBuffer];
+  nextLineBuffer = (nextLineBuffer + 1) % nbLineBuffers;
+  return buffer;
+}
 
 void Process(void* /*instance*/) {
   RefreshWatchdog();
@@ -90,6 +118,7 @@ void Process(void* /*instance*/) {
   spiNorFlash.Wakeup();
   brightnessController.Init();
   lcd.Init();
+  freeLineBuffers = xSemaphoreCreateCounting(nbLineBuffers, nbLineBuffers);
 
   NRF_LOG_INFO("Display logo")
   DisplayLogo();
@@ -120,17 +149,19 @@ void Process(void* /*instance*/) {
 void DisplayLogo() {
   Pinetime::Tools::RleDecoder rleDecoder(infinitime_nb, sizeof(infinitime_nb));
   for (int i = 0; i < displayWidth; i++) {
-    rleDecoder.DecodeNext(displayBuffer, displayWidth * bytesPerPixel);
-    lcd.DrawBuffer(0, i, displayWidth, 1, reinterpret_cast<const uint8_t*>(displayBuffer), displayWidth * bytesPerPixel);
+    uint8_t* line = TakeLineBuffer();
+    rleDecoder.DecodeNext(line, displayWidth * bytesPerPixel);
+    lcd.DrawBuffer(0, i, displayWidth, 1, line, displayWidth * bytesPerPixel, OnLineSent);
   }
 }
 
 void DisplayProgressBar(uint8_t percent, uint16_t color) {
   static constexpr uint8_t barHeight = 20;
-  std::fill(displayBuffer, displayBuffer + (displayWidth * bytesPerPixel), color);
   for (int i = 0; i < barHeight; i++) {
+    uint8_t* line = TakeLineBuffer();
+    std::fill(line, line + (displayWidth * bytesPerPixel), color);
     uint16_t barWidth = std::min(static_cast<float>(percent) * 2.4f, static_cast<float>(displayWidth));
-    lcd.DrawBuffer(0, displayWidth - barHeight + i, barWidth, 1, reinterpret_cast<const uint8_t*>(displayBuffer), barWidth * bytesPerPixel);
+    lcd.DrawBuffer(0, displayWidth - barHeight + i, barWidth, 1, line, barWidth * bytesPerPixel, OnLineSent);
   }
 }
 
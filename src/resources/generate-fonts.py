@@ -6,6 +6,7 @@ import json
 import shutil
 import typing
 import os.path
+import struct
 import argparse
 import subprocess
 
@@ -34,6 +35,133 @@ def gen_lvconv_line(lv_font_conv: str, dest: str, size: int, bpp: int, format: s
 
     return args
 
+class BitReader(object):
+    def __init__(self, data: bytes):
+        self.data = data
+        self.pos = 0
+
+    def read(self, bits: int) -> int:
+        value = 0
+        for _ in range(bits):
+            byte = self.data[self.pos // 8]
+            value = (value << 1) | ((byte >> (7 - self.pos % 8)) & 1)
+            self.pos += 1
+        return value
+
+    def read_signed(self, bits: int) -> int:
+        value = self.read(bits)
+        if bits and value & (1 << (bits - 1)):
+            value -= 1 << bits
+        return value
+
+
+def read_lvgl_tables(data: bytes) -> typing.Dict[str, bytes]:
+    # Each table of the LVGL binary font format starts with its length (header included) and a 4 chars label
+    tables = {}
+    offset = 0
+    while offset + 8 <= len(data):
+        length, label = struct.unpack_from('<I4s', data, offset)
+        tables[label.decode('ascii')] = data[offset:offset + length]
+        offset += length
+    return tables
+
+
+def convert_to_stream(src: str, dest: str):
+    """Convert a font generated by lv_font_conv in the LVGL binary format into the streamed layout
+    loaded by Pinetime::Components::StreamedFont (src/displayapp/StreamedFont.h).
+
+    All values are little-endian:
+        header     magic "IFNT", version, number of ranges and glyphs, line height, base line,
+                   underline position and thickness, bpp, offset of the bitmaps
+        ranges     first code point, length and id of the glyph of the first code point
+        glyphs     offset and size of the bitmap, advance width (1/16 px), box width and height, x and y offsets
+        bitmaps    glyph bitmaps, bpp bits per pixel, rows not padded to bytes
+
+    Glyphs are sorted by code point so that consecutive code points map to consecutive glyphs. Kerning is not kept.
+    """
+    with open(src, 'rb') as fd:
+        tables = read_lvgl_tables(fd.read())
+
+    (_, _, _, _, _, ascent, descent, _, _, _, _, _, default_advance_width, _,
+     index_to_loc_format, _, advance_width_format, bpp, xy_bits, wh_bits, advance_width_bits,
+     compression_id, subpixels_mode, _, underline_position, underline_thickness) = struct.unpack_from(
+        '<I4sIHHHhHhHhhHHBBBBBBBBBBhH', tables['head'])
+    if compression_id != 0 or subpixels_mode != 0:
+        sys.exit(f'Error: {src} is compressed or uses subpixel rendering, not supported by the streamed layout')
+
+    glyph_ids = {}
+    cmap = tables['cmap']
+    subtables_count, = struct.unpack_from('<I', cmap, 8)
+    for i in range(subtables_count):
+        data_offset, range_start, range_length, glyph_id_start, entries_count, format_type, _ = struct.unpack_from(
+            '<IIHHHBB', cmap, 12 + 16 * i)
+        if format_type == 0:  # format 0, full
+            offsets = cmap[data_offset:data_offset + entries_count]
+            for code, offset in enumerate(offsets):
+                glyph_ids[range_start + code] = glyph_id_start + offset
+        elif format_type == 1:  # sparse, full
+            codes = struct.unpack_from(f'<{entries_count}H', cmap, data_offset)
+            offsets = struct.unpack_from(f'<{entries_count}H', cmap, data_offset + 2 * entries_count)
+            for code, offset in zip(codes, offsets):
+                glyph_ids[range_start + code] = glyph_id_start + offset
+        elif format_type == 2:  # format 0, tiny
+            for code in range(range_length):
+                glyph_ids[range_start + code] = glyph_id_start + code
+        elif format_type == 3:  # sparse, tiny
+            codes = struct.unpack_from(f'<{entries_count}H', cmap, data_offset)
+            for index, code in enumerate(codes):
+                glyph_ids[range_start + code] = glyph_id_start + index
+        else:
+            sys.exit(f'Error: unknown cmap format {format_type} in {src}')
+
+    loca = tables['loca']
+    loca_count, = struct.unpack_from('<I', loca, 8)
+    loca_format = '<{}H' if index_to_loc_format == 0 else '<{}I'
+    glyph_offsets = struct.unpack_from(loca_format.format(loca_count), loca, 12) + (len(tables['glyf']),)
+
+    code_points = sorted(glyph_ids)
+    ranges = []
+    for index, code in enumerate(code_points):
+        if ranges and ranges[-1][0] + ranges[-1][1] == code:
+            ranges[-1][1] += 1
+        else:
+            ranges.append([code, 1, index])
+
+    glyphs = b''
+    bitmaps = b''
+    for code in code_points:
+        glyph_id = glyph_ids[code]
+        reader = BitReader(tables['glyf'][glyph_offsets[glyph_id]:glyph_offsets[glyph_id + 1]])
+        advance_width = reader.read(advance_width_bits) if advance_width_bits else default_advance_width
+        if advance_width_format == 0:
+            advance_width <<= 4
+        offset_x = reader.read_signed(xy_bits)
+        offset_y = reader.read_signed(xy_bits)
+        box_width = reader.read(wh_bits)
+        box_height = reader.read(wh_bits)
+        if box_width > 255 or box_height > 255 or not -128 <= offset_x <= 127 or not -128 <= offset_y <= 127:
+            sys.exit(f'Error: glyph {code} of {src} is too large for the streamed layout')
+
+        nbits = box_width * box_height * bpp
+        bitmap = bytearray((nbits + 7) // 8)
+        for bit in range(nbits):
+            if reader.read(1):
+                bitmap[bit // 8] |= 0x80 >> (bit % 8)
+        glyphs += struct.pack('<IHHBBbb', len(bitmaps), len(bitmap), advance_width, box_width, box_height,
+                              offset_x, offset_y)
+        bitmaps += bitmap
+
+    header_size = 22
+    bitmaps_offset = header_size + 8 * len(ranges) + len(glyphs)
+    with open(dest, 'wb') as fd:
+        fd.write(struct.pack('<4sHHHhhbBBBI', b'IFNT', 1, len(ranges), len(code_points), ascent - descent, -descent,
+                             underline_position, underline_thickness, bpp, 0, bitmaps_offset))
+        for first, length, glyph_id in ranges:
+            fd.write(struct.pack('<IHH', first, length, glyph_id))
+        fd.write(glyphs)
+        fd.write(bitmaps)
+
+
 def main():
     ap = argparse.ArgumentParser(description='auto generate LVGL font files from fonts')
     ap.add_argument('config', type=str, help='config file to use')
@@ -66,10 +194,18 @@ def main():
         sources = font.pop('sources')
         patches = font.pop('patches') if 'patches' in font else  []
         font['sources'] = [Source(thing) for thing in sources]
-        extension = 'c' if font['format'] != 'bin' else 'bin'
+        extension = 'c' if font['format'] not in ('bin', 'stream') else 'bin'
         font.pop('target_path')
-        line = gen_lvconv_line(args.lv_font_conv, f'{name}.{extension}', **font)
-        subprocess.check_call(line)
+        if font['format'] == 'stream':
+            # Generated in the LVGL binary format first, then converted
+            font['format'] = 'bin'
+            line = gen_lvconv_line(args.lv_font_conv, f'{name}.lvgl.bin', **font)
+            subprocess.check_call(line)
+            convert_to_stream(f'{name}.lvgl.bin', f'{name}.{extension}')
+            os.remove(f'{name}.lvgl.bin')
+        else:
+            line = gen_lvconv_line(args.lv_font_conv, f'{name}.{extension}', **font)
+            subprocess.check_call(line)
         if patches:
             for patch in patches:
                 subprocess.check_call(['/usr/bin/env', 'patch', name+'.'+extension, patch])
@@ -7,11 +7,52 @@
 
 void Pinetime::System::SystemMonitor::Process() {
   if (xTaskGetTickCount() - lastTick > 10000) {
-    NRF_LOG_INFO("---------------------------------------\nFree heap : %d", xPortGetFreeHeapSize());
+    HeapStats_t heapStats;
+    vPortGetHeapStats(&heapStats);
+    NRF_LOG_INFO("---------------------------------------\nFree heap : %d (min %d), largest block : %d, free blocks : %d",
+                 heapStats.xAvailableHeapSpaceInBytes,
+                 heapStats.xMinimumEverFreeBytesRemaining,
+                 heapStats.xSizeOfLargestFreeBlockInBytes,
+                 heapStats.xNumberOfFreeBlocks);
+    uint32_t histogram[portHEAP_HISTOGRAM_BUCKETS];
+    vPortGetHeapHistogram(histogram);
+    NRF_LOG_INFO("Allocation sizes : <=16 %d, <=32 %d, <=64 %d, <=128 %d", histogram[0], histogram[1], histogram[2], histogram[3]);
+    NRF_LOG_INFO("Allocation sizes : <=256 %d, <=512 %d, <=1024 %d, >1024 %d", histogram[4], histogram[5], histogram[6], histogram[7]);
+    HeapTaskStats_t heapTaskStats[10];
+    auto nbOwners = uxPortGetHeapTaskStats(heapTaskStats, 10);
+    for (uint32_t i = 0; i < nbOwners; i++) {
+      const char* name = (heapTaskStats[i].pvTask != nullptr) ? pcTaskGetName(static_cast<TaskHandle_t>(heapTaskStats[i].pvTask)) : "-";
+      NRF_LOG_INFO("Heap [%s] - %d (peak %d)", name, heapTaskStats[i].xCurrentBytes, heapTaskStats[i].xPeakBytes);
+    }
+  #if configHEAP_TRACE_LENGTH > 0
+    HeapTraceEntry_t trace[configHEAP_TRACE_LENGTH];
+    auto nbEntries = uxPortGetHeapTrace(trace, configHEAP_TRACE_LENGTH);
+    for (uint32_t i = 0; i < nbEntries; i++) {
+      NRF_LOG_INFO("Heap trace : %s 0x%x, %d bytes, owner %d",
+                   trace[i].ucIsFree ? "free" : "alloc",
+                   trace[i].pvAddress,
+                   trace[i].usSize,
+                   trace[i].ucOwner);
+    }
+  #endif
+  #if configGENERATE_RUN_TIME_STATS == 1
+    RunTimeStats_t runTimeStats;
+    vPortGetRunTimeStats(&runTimeStats);
+    NRF_LOG_INFO("Run time : %d, sleep %d (%d times), ISR SPI %d, TWI %d, GPIOTE %d",
+                 runTimeStats.ulTotalTime,
+                 runTimeStats.ulSleepTime,
+                 runTimeStats.ulSleepCount,
+                 runTimeStats.ulIsrTime[eRunTimeIsrSpi],
+                 runTimeStats.ulIsrTime[eRunTimeIsrTwi],
+                 runTimeStats.ulIsrTime[eRunTimeIsrGpiote]);
+  #endif
     TaskStatus_t tasksStatus[10];
     auto nb = uxTaskGetSystemState(tasksStatus, 10, nullptr);
     for (uint32_t i = 0; i < nb; i++) {
-      NRF_LOG_INFO("Task [%s] - %d", tasksStatus[i].pcTaskName, tasksStatus[i].usStackHighWaterMark);
+      NRF_LOG_INFO("Task [%s] - %d, run time %d",
+                   tasksStatus[i].pcTaskName,
+                   tasksStatus[i].usStackHighWaterMark,
+                   tasksStatus[i].ulRunTimeCounter);
       if (tasksStatus[i].usStackHighWaterMark < 20)
         NRF_LOG_INFO("WARNING!!! Task %s task is nearly full, only %dB available",
                      tasksStatus[i].pcTaskName,
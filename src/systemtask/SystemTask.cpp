@@ -183,10 +183,19 @@ void SystemTask::Work() {
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "EndlessLoop"
   while (true) {
-    UpdateMotion();
+    // When the accelerometer buffers its samples in its FIFO, it's drained in batches of a few samples instead of
+    // waking up every 100ms
+    const TickType_t motionUpdatePeriod =
+      motionSensor.IsFifoEnabled() ? pdMS_TO_TICKS(motionUpdateBatchSize * Drivers::Bma421::fifoSamplePeriod) : pdMS_TO_TICKS(100);
+    if (xTaskGetTickCount() - lastMotionUpdate >= motionUpdatePeriod) {
+      lastMotionUpdate = xTaskGetTickCount();
+      UpdateMotion();
+    }
+    const TickType_t sinceMotionUpdate = xTaskGetTickCount() - lastMotionUpdate;
+    const TickType_t timeout = (sinceMotionUpdate < motionUpdatePeriod) ? motionUpdatePeriod - sinceMotionUpdate : 0;
 
     Messages msg;
-    if (xQueueReceive(systemTasksMsgQueue, &msg, 100) == pdTRUE) {
+    if (xQueueReceive(systemTasksMsgQueue, &msg, timeout) == pdTRUE) {
       switch (msg) {
         case Messages::EnableSleeping:
           wakeLocksHeld--;
@@ -374,6 +383,7 @@ void SystemTask::Work() {
     }
 
     monitor.Process();
+    dateTimeController.UpdateTime();
     NoInit_BackUpTime = dateTimeController.CurrentDateTime();
     if (nrf_gpio_pin_read(PinMap::Button) == 0) {
       watchdog.Reload();
@@ -444,7 +454,7 @@ void SystemTask::UpdateMotion() {
 
   auto motionValues = motionSensor.Process();
 
-  motionController.Update(motionValues.x, motionValues.y, motionValues.z, motionValues.steps);
+  motionController.Update({motionValues.samples.data(), motionValues.nbSamples}, motionValues.steps, motionValues.samplePeriod);
 
   if (settingsController.GetNotificationStatus() != Controllers::Settings::Notification::Sleep) {
     if ((settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::RaiseWrist) &&
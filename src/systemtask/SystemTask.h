@@ -131,6 +131,9 @@ namespace Pinetime {
       void GoToRunning();
       void GoToSleep();
       void UpdateMotion();
+      // Number of accelerometer FIFO samples drained at each motion update (well below Bma421::maxFifoSamples)
+      static constexpr uint32_t motionUpdateBatchSize = 4;
+      TickType_t lastMotionUpdate = 0;
       bool stepCounterMustBeReset = false;
       static constexpr TickType_t batteryMeasurementPeriod = pdMS_TO_TICKS(10 * 60 * 1000);
 
@@ -0,0 +1,31 @@
+#include "utility/ChangeBus.h"
+#include <atomic>
+
+using namespace Pinetime::Utility;
+
+namespace {
+  // Set along with the pending topics once the listener was notified of them
+  constexpr uint32_t listenerNotified = 1U << 31;
+  std::atomic<uint32_t> pendingTopics {0};
+  ChangeBus::Listener changeListener = nullptr;
+  void* changeListenerContext = nullptr;
+}
+
+void ChangeBus::SetListener(Listener listener, void* context) {
+  changeListenerContext = context;
+  changeListener = listener;
+}
+
+void ChangeBus::Publish(Topic topic) {
+  if ((pendingTopics.fetch_or(TopicMask(topic) | listenerNotified) & listenerNotified) != 0) {
+    return;
+  }
+  if (changeListener == nullptr || !changeListener(changeListenerContext)) {
+    // Keep the topics pending, but let the next change try again
+    pendingTopics.fetch_and(~listenerNotified);
+  }
+}
+
+uint32_t ChangeBus::TakeChanges() {
+  return pendingTopics.exchange(0) & ~listenerNotified;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Utility {
+    // Values published by the controllers when they change
+    enum class Topic : uint8_t { Time, Battery, Ble, Notifications, HeartRate, Steps, Weather, Music };
+
+    constexpr uint32_t TopicMask(Topic topic) {
+      return 1U << static_cast<uint8_t>(topic);
+    }
+
+    template <typename... Topics>
+    constexpr uint32_t TopicMask(Topic topic, Topics... topics) {
+      return TopicMask(topic) | TopicMask(topics...);
+    }
+
+    // Change notifications from the controllers to the display task. Publish() can be called from any task or
+    // interrupt: it records the topic and calls the listener only if it wasn't already notified of pending changes,
+    // so a burst of changes wakes the listener once. The listener collects all the pending topics with TakeChanges().
+    // If the listener returns false (it could not be woken up), the next Publish() calls it again.
+    class ChangeBus {
+    public:
+      using Listener = bool (*)(void* context);
+
+      static void SetListener(Listener listener, void* context);
+      static void Publish(Topic topic);
+      static uint32_t TakeChanges();
+    };
+  }
+}
@@ -0,0 +1,45 @@
+#include "utility/Crc16.h"
+
+#include <array>
+
+using namespace Pinetime::Utility;
+
+namespace {
+  using CrcTable = std::array<uint16_t, 256>;
+
+  constexpr CrcTable MakeTable() {
+    CrcTable table {};
+    for (uint16_t i = 0; i < 256; i++) {
+      uint16_t crc = i << 8;
+      for (int bit = 0; bit < 8; bit++) {
+        crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+      }
+      table[i] = crc;
+    }
+    return table;
+  }
+
+  // Slice-by-2: the second table gives the CRC of a byte followed by a zero byte, so that
+  // two bytes are processed with two lookups.
+  constexpr CrcTable MakeSecondTable(const CrcTable& table) {
+    CrcTable second {};
+    for (uint16_t i = 0; i < 256; i++) {
+      second[i] = static_cast<uint16_t>(table[i] << 8) ^ table[table[i] >> 8];
+    }
+    return second;
+  }
+
+  constexpr CrcTable table0 = MakeTable();
+  constexpr CrcTable table1 = MakeSecondTable(table0);
+}
+
+uint16_t Pinetime::Utility::Crc16(const uint8_t* data, size_t size, uint16_t crc) {
+  for (; size >= 2; size -= 2, data += 2) {
+    uint16_t x = crc ^ ((data[0] << 8) | data[1]);
+    crc = table1[x >> 8] ^ table0[x & 0xFF];
+  }
+  if (size > 0) {
+    crc = static_cast<uint16_t>(crc << 8) ^ table0[(crc >> 8) ^ data[0]];
+  }
+  return crc;
+}
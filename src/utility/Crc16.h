@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Utility {
+    // CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF), as used by the Nordic DFU protocol.
+    // Pass the result of the previous call as `crc` to continue the computation over the next block.
+    uint16_t Crc16(const uint8_t* data, size_t size, uint16_t crc = 0xFFFF);
+  }
+}
@@ -0,0 +1,356 @@
+// Replays HRS3300 traces through Controllers::Ppg on the host, the way HeartRateTask feeds it on the watch, and reports
+// the accuracy of the heart rate against a reference, the cost of Preprocess() and HeartRate() and their peak stack use.
+// See README.md for the trace format.
+
+#include <pthread.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+#endif
+#include "components/heartrate/Ppg.h"
+
+using Pinetime::Controllers::Ppg;
+
+namespace {
+#if defined(__x86_64__) || defined(__i386__)
+  constexpr const char* counterUnit = "cycles";
+
+  inline uint64_t ReadCounter() {
+    return __rdtsc();
+  }
+#else
+  constexpr const char* counterUnit = "ns";
+
+  inline uint64_t ReadCounter() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+#endif
+
+#ifdef HEARTRATE_FIXED_POINT
+  constexpr const char* variant = "fixed point";
+#else
+  constexpr const char* variant = "floating point";
+#endif
+
+  constexpr float sampleFreq = 1000.0f / Ppg::deltaTms;
+  // The calls are replayed on a stack of this size, painted with stackPattern to find the deepest byte they wrote
+  constexpr size_t stackSize = 256 * 1024;
+  constexpr uint8_t stackPattern = 0xa5;
+
+  struct Sample {
+    uint16_t hrs;
+    uint16_t als;
+    // Reference heart rate, 0 if unknown
+    float bpm;
+  };
+
+  struct Trace {
+    std::string name;
+    std::vector<Sample> samples;
+  };
+
+  // Filled by the replay thread, which must not allocate nor call anything but the algorithm
+  struct Replay {
+    const Trace* trace;
+    Ppg* ppg;
+    // Value returned by HeartRate() for each sample
+    std::vector<int> result;
+    std::vector<uint64_t> preprocessCost;
+    std::vector<uint64_t> heartRateCost;
+    uintptr_t stackBase;
+  };
+
+  struct Summary {
+    size_t readings = 0;
+    size_t compared = 0;
+    size_t withinTolerance = 0;
+    float firstReading = -1.0f;
+    double errorSum = 0.0;
+    float maxError = 0.0f;
+    double preprocessCost = 0.0;
+    double heartRateCost = 0.0;
+    double analysisCost = 0.0;
+    uint64_t maxHeartRateCost = 0;
+    size_t stackUse = 0;
+
+    float MeanError() const {
+      return compared > 0 ? static_cast<float>(errorSum / compared) : 0.0f;
+    }
+  };
+
+  // Stack address of a function called by the caller of StackBase(): the frames of the measured calls start here
+  __attribute__((noinline)) uintptr_t StackBase() {
+    return reinterpret_cast<uintptr_t>(__builtin_frame_address(0));
+  }
+
+  // Same sequence of calls as HeartRateTask::Work()
+  __attribute__((noinline)) void Run(Replay& replay) {
+    replay.stackBase = StackBase();
+    Ppg& ppg = *replay.ppg;
+    for (size_t i = 0; i < replay.trace->samples.size(); i++) {
+      const Sample& sample = replay.trace->samples[i];
+      uint64_t start = ReadCounter();
+      int8_t ambient = ppg.Preprocess(sample.hrs, sample.als);
+      uint64_t preprocessed = ReadCounter();
+      int bpm = ppg.HeartRate();
+      uint64_t end = ReadCounter();
+      replay.preprocessCost[i] = preprocessed - start;
+      replay.heartRateCost[i] = end - preprocessed;
+      replay.result[i] = bpm;
+
+      if (ambient > 0) {
+        ppg.Reset(true);
+      } else if (bpm < 0) {
+        ppg.Reset(false);
+      }
+    }
+  }
+
+  void* RunThread(void* argument) {
+    Run(*static_cast<Replay*>(argument));
+    return nullptr;
+  }
+
+  bool ReplayOnPaintedStack(Replay& replay, size_t& stackUse) {
+    auto* stack = static_cast<uint8_t*>(std::aligned_alloc(4096, stackSize));
+    if (stack == nullptr) {
+      return false;
+    }
+    std::memset(stack, stackPattern, stackSize);
+
+    pthread_attr_t attributes;
+    pthread_t thread;
+    pthread_attr_init(&attributes);
+    bool started =
+      pthread_attr_setstack(&attributes, stack, stackSize) == 0 && pthread_create(&thread, &attributes, RunThread, &replay) == 0;
+    pthread_attr_destroy(&attributes);
+    if (started) {
+      pthread_join(thread, nullptr);
+      // The stack grows down: the deepest byte written is the first one that isn't painted anymore
+      size_t deepest = 0;
+      while (deepest < stackSize && stack[deepest] == stackPattern) {
+        deepest++;
+      }
+      stackUse = replay.stackBase - reinterpret_cast<uintptr_t>(stack + deepest);
+    }
+    std::free(stack);
+    return started;
+  }
+
+  Summary Analyze(const Trace& trace, Ppg& ppg) {
+    Replay replay {&trace, &ppg, {}, {}, {}, 0};
+    replay.result.resize(trace.samples.size());
+    replay.preprocessCost.resize(trace.samples.size());
+    replay.heartRateCost.resize(trace.samples.size());
+
+    Summary summary;
+    if (!ReplayOnPaintedStack(replay, summary.stackUse)) {
+      std::fprintf(stderr, "%s: could not start the replay thread\n", trace.name.c_str());
+      std::exit(EXIT_FAILURE);
+    }
+
+    size_t analyses = 0;
+    for (size_t i = 0; i < trace.samples.size(); i++) {
+      summary.preprocessCost += replay.preprocessCost[i];
+      summary.heartRateCost += replay.heartRateCost[i];
+      summary.maxHeartRateCost = std::max(summary.maxHeartRateCost, replay.heartRateCost[i]);
+
+      // HeartRate() returns 0 until the window is full and between two analyses, -1 when it lost the signal
+      const int bpm = replay.result[i];
+      if (bpm == 0) {
+        continue;
+      }
+      analyses++;
+      summary.analysisCost += replay.heartRateCost[i];
+      if (bpm < 0) {
+        continue;
+      }
+      summary.readings++;
+      if (summary.firstReading < 0.0f) {
+        summary.firstReading = static_cast<float>(i + 1) / sampleFreq;
+      }
+      const float reference = trace.samples[i].bpm;
+      if (reference > 0.0f) {
+        const float error = std::fabs(static_cast<float>(bpm) - reference);
+        summary.compared++;
+        summary.errorSum += error;
+        summary.maxError = std::max(summary.maxError, error);
+        if (error <= 5.0f) {
+          summary.withinTolerance++;
+        }
+      }
+    }
+
+    const size_t samples = std::max<size_t>(trace.samples.size(), 1);
+    summary.preprocessCost /= samples;
+    summary.heartRateCost /= samples;
+    summary.analysisCost = analyses > 0 ? summary.analysisCost / analyses : 0.0;
+    return summary;
+  }
+
+  // Synthetic PPG: a pulse wave with its second harmonic, breathing, a slow drift of the DC level and sensor noise
+  struct Synthetic {
+    const char* name;
+    float startBpm;
+    float endBpm;
+    float pulseAmplitude;
+    float noise;
+    float breathingAmplitude;
+    float drift; // ADC counts per second
+  };
+
+  constexpr Synthetic syntheticTraces[] = {
+    {"rest-60", 60.0f, 60.0f, 30.0f, 3.0f, 10.0f, 0.0f},
+    {"weak-75", 75.0f, 75.0f, 8.0f, 3.0f, 5.0f, 0.0f},
+    {"drift-90", 90.0f, 90.0f, 20.0f, 3.0f, 40.0f, 2.0f},
+    {"walk-110", 110.0f, 110.0f, 25.0f, 5.0f, 15.0f, -1.0f},
+    {"run-160", 160.0f, 160.0f, 20.0f, 6.0f, 20.0f, 0.0f},
+    {"ramp-70-140", 70.0f, 140.0f, 25.0f, 4.0f, 15.0f, 0.5f},
+  };
+
+  Trace Generate(const Synthetic& synthetic, unsigned seed) {
+    constexpr float duration = 120.0f;
+    constexpr float pi = 3.14159265f;
+    constexpr float breathingFreq = 0.25f;
+    constexpr uint16_t ambientLight = 200;
+    const auto count = static_cast<size_t>(duration * sampleFreq);
+
+    std::mt19937 generator(seed);
+    std::normal_distribution<float> noise(0.0f, synthetic.noise);
+    Trace trace {synthetic.name, {}};
+    trace.samples.reserve(count);
+    float phase = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+      const float t = static_cast<float>(i) / sampleFreq;
+      const float bpm = synthetic.startBpm + (synthetic.endBpm - synthetic.startBpm) * t / duration;
+      phase += 2.0f * pi * (bpm / 60.0f) / sampleFreq;
+      const float pulse = std::sin(phase) + 0.35f * std::sin(2.0f * phase + 0.8f);
+      const float value = 6000.0f + synthetic.drift * t + synthetic.breathingAmplitude * std::sin(2.0f * pi * breathingFreq * t) +
+                          synthetic.pulseAmplitude * pulse + noise(generator);
+      trace.samples.push_back({static_cast<uint16_t>(std::clamp(value, 0.0f, 65535.0f)), ambientLight, bpm});
+    }
+    return trace;
+  }
+
+  // One sample per line, sampled every Ppg::deltaTms: "hrs,als[,bpm]". Empty lines and lines starting with # are skipped.
+  bool Load(const char* path, float bpm, Trace& trace) {
+    std::ifstream file(path);
+    if (!file) {
+      return false;
+    }
+    trace = {path, {}};
+    std::string line;
+    while (std::getline(file, line)) {
+      if (line.empty() || line[0] == '#') {
+        continue;
+      }
+      std::replace(line.begin(), line.end(), ',', ' ');
+      std::istringstream fields(line);
+      unsigned hrs;
+      unsigned als;
+      float reference = bpm;
+      if (!(fields >> hrs >> als)) {
+        return false;
+      }
+      fields >> reference;
+      trace.samples.push_back({static_cast<uint16_t>(hrs), static_cast<uint16_t>(als), bpm > 0.0f ? bpm : reference});
+    }
+    return true;
+  }
+
+  void Usage(const char* program) {
+    std::fprintf(stderr,
+                 "Usage: %s [--bpm REFERENCE] [--max-error BPM] [trace.csv...]\n"
+                 "Replays the synthetic traces when no trace is given.\n",
+                 program);
+  }
+}
+
+int main(int argc, char** argv) {
+  float bpm = 0.0f;
+  float maxError = -1.0f;
+  std::vector<Trace> traces;
+  for (int i = 1; i < argc; i++) {
+    if ((std::strcmp(argv[i], "--bpm") == 0 || std::strcmp(argv[i], "--max-error") == 0) && i + 1 < argc) {
+      (argv[i][2] == 'b' ? bpm : maxError) = std::strtof(argv[i + 1], nullptr);
+      i++;
+    } else if (argv[i][0] == '-') {
+      Usage(argv[0]);
+      return EXIT_FAILURE;
+    } else {
+      Trace trace;
+      if (!Load(argv[i], bpm, trace)) {
+        std::fprintf(stderr, "%s: cannot read the trace\n", argv[i]);
+        return EXIT_FAILURE;
+      }
+      traces.push_back(std::move(trace));
+    }
+  }
+  if (traces.empty()) {
+    unsigned seed = 1;
+    for (const auto& synthetic : syntheticTraces) {
+      traces.push_back(Generate(synthetic, seed++));
+    }
+  }
+
+  std::printf("Ppg (%s), costs in %s per call\n", variant, counterUnit);
+  std::printf("%-16s %8s %8s %8s %8s %8s %8s %11s %10s %10s %10s %6s\n",
+              "trace",
+              "samples",
+              "readings",
+              "first[s]",
+              "MAE",
+              "max err",
+              "<=5bpm",
+              "Preprocess",
+              "HeartRate",
+              "analysis",
+              "worst",
+              "stack");
+
+  bool passed = true;
+  size_t maxStackUse = 0;
+  for (const auto& trace : traces) {
+    // Reuse a single instance, as HeartRateTask does, to also replay the Reset() between measurements
+    static Ppg ppg;
+    ppg.Reset(true);
+    const Summary summary = Analyze(trace, ppg);
+    maxStackUse = std::max(maxStackUse, summary.stackUse);
+
+    char within[16] = "-";
+    if (summary.compared > 0) {
+      std::snprintf(within, sizeof(within), "%.0f%%", 100.0 * summary.withinTolerance / summary.compared);
+    }
+    std::printf("%-16s %8zu %8zu %8.1f %8.2f %8.0f %8s %11.0f %10.0f %10.0f %10llu %6zu\n",
+                trace.name.c_str(),
+                trace.samples.size(),
+                summary.readings,
+                summary.firstReading,
+                summary.MeanError(),
+                summary.maxError,
+                within,
+                summary.preprocessCost,
+                summary.heartRateCost,
+                summary.analysisCost,
+                static_cast<unsigned long long>(summary.maxHeartRateCost),
+                summary.stackUse);
+
+    if (maxError >= 0.0f && (summary.readings == 0 || summary.MeanError() > maxError)) {
+      std::printf("%s: FAILED, mean error above %.1f BPM or no reading\n", trace.name.c_str(), maxError);
+      passed = false;
+    }
+  }
+  std::printf("Peak stack use: %zu bytes (host)\n", maxStackUse);
+  return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}